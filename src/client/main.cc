@@ -8,35 +8,65 @@
 #include <ixwebsocket/IXWebSocket.h>
 
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 
 #include "net/net_init_manager.h"
+#include "net/wire_protocol.h"
 
-int main() {
+namespace {
+
+// Prints every frame of a binary message in its text form.
+void PrintFrames(std::string_view data) {
+  while (!data.empty()) {
+    const auto frame = common::net::DecodeFrame(data);
+    if (!frame) {
+      std::cout << "Malformed message from the server\n";
+      return;
+    }
+    std::cout << common::net::EncodeText(frame->message) << std::endl;
+    data.remove_prefix(frame->size);
+  }
+}
+
+} // namespace
+
+// Pass --binary to use the binary protocol instead of text. Every line typed
+// is sent as an action, e.g. "call" or "raise 200".
+int main(int argc, char* argv[]) {
   srand(time(0uz) * 100.0f);
   common::net::NetInitManager::Initialize();
-  ix::WebSocket webSocket;
+  // Shared with the stdin reader, which may outlive `main` blocked on input.
+  const auto webSocket = std::make_shared<ix::WebSocket>();
   std::cout << "Creating websocket\n";
-  std::string url = std::format("ws://localhost:8008/user-{}", rand());
-  webSocket.setUrl(url);
+  const bool binary = argc > 1 && std::string_view(argv[1]) == "--binary";
+  std::string url = std::format("ws://localhost:8008/user-{}{}", rand(),
+                                binary ? "?wire=binary" : "");
+  webSocket->setUrl(url);
   std::mutex wait_mutex;
   std::condition_variable cv;
 
   // Optional heart beat, sent every 45 seconds when there is not any traffic
   // to make sure that load balancers do not kill an idle connection.
-  webSocket.setPingInterval(45);
+  webSocket->setPingInterval(45);
 
   // Per message deflate connection is not enabled by default. You can tweak its
   // parameters, enable or disable it with
-  webSocket.enablePerMessageDeflate();
-  webSocket.disablePerMessageDeflate();
+  webSocket->enablePerMessageDeflate();
+  webSocket->disablePerMessageDeflate();
 
   // Setup a callback to be fired when a message or an event (open, close,
   // error) is received
-  webSocket.setOnMessageCallback([&cv](const ix::WebSocketMessagePtr& msg) {
+  webSocket->setOnMessageCallback([&cv](const ix::WebSocketMessagePtr& msg) {
     if (msg->type == ix::WebSocketMessageType::Message) {
-      std::cout << msg->str << std::endl;
+      if (msg->binary) {
+        PrintFrames(msg->str);
+      } else {
+        std::cout << msg->str << std::endl;
+      }
     }
 
     if (msg->type == ix::WebSocketMessageType::Close) {
@@ -46,12 +76,33 @@ int main() {
 
   // Now that our callback is setup, we can start our background thread and
   // receive messages
-  webSocket.start();
+  webSocket->start();
+
+  const common::net::WireFormat format =
+    binary ? common::net::WireFormat::kBinary : common::net::WireFormat::kText;
+  // Detached, since it blocks on stdin until the next line. It owns what it
+  // uses, so it is safe to leave running when `main` returns.
+  std::thread([webSocket, format] {
+    for (std::string line; std::getline(std::cin, line);) {
+      const auto action =
+        common::net::DecodeAction(line, common::net::WireFormat::kText);
+      if (!action) {
+        std::cout << "Unknown action\n";
+        continue;
+      }
+      const std::string data = common::net::Encode(*action, format);
+      if (format == common::net::WireFormat::kBinary) {
+        webSocket->sendBinary(data);
+      } else {
+        webSocket->sendText(data);
+      }
+    }
+  }).detach();
 
   std::unique_lock lock{wait_mutex};
   cv.wait(lock);
 
   // Stop the connection
-  webSocket.stop();
+  webSocket->stop();
   return 0;
 }
@@ -1,15 +1,22 @@
 #ifndef COMMON_MODEL_CARD_H_
 #define COMMON_MODEL_CARD_H_
 
+#include <cassert>
+#include <type_traits>
+
 #include "aliasing.h"
 
 namespace model {
 
 constexpr u32 gSuitNumber = 4;
 constexpr u32 gRankNumber = 13;
+constexpr u32 gCardNumber = gSuitNumber * gRankNumber;
 
 // `Card` is a main class in the data model of the application - it models a
 // singular playing card.
+//
+// A card is a single byte holding `value()`, so it is trivially copyable,
+// arrays of cards are plain memory and a whole hand fits in a register.
 class Card {
   public:
     enum class Suit : u8 {
@@ -41,35 +48,54 @@ class Card {
       kMemberCount = 13,
     };
 
-    Card() = default;
-    Card(Card::Suit suit, Card::Rank rank);
-    Card(const Card& other);
-    Card(Card&& other) noexcept;
+    constexpr Card() = default;
+    constexpr Card(Card::Suit suit, Card::Rank rank)
+      : value_(static_cast<u8>(static_cast<u32>(suit) * gRankNumber +
+                               static_cast<u32>(rank))) {
+    }
 
-    void operator=(const Card& other);
-    void operator=(Card&& other) noexcept;
+    constexpr bool operator==(const Card& other) const = default;
 
-    bool operator==(const Card& other) const {
-      return other.suit() == suit() && other.rank() == rank();
+    // Cards are ordered by rank first and by suit second.
+    constexpr bool operator>(const Card& other) const {
+      return other < *this;
+    }
+    constexpr bool operator<(const Card& other) const {
+      if (rank() == other.rank()) {
+        return suit() < other.suit();
+      }
+      return rank() < other.rank();
     }
-    bool operator>(const Card& other) const;
-    bool operator<(const Card& other) const;
 
-    Card::Suit suit() const {
-      return suit_;
+    constexpr Card::Suit suit() const {
+      return static_cast<Suit>(value_ / gRankNumber);
     }
 
-    Card::Rank rank() const {
-      return rank_;
+    constexpr Card::Rank rank() const {
+      return static_cast<Rank>(value_ % gRankNumber);
     }
 
-    u32 value() const;
+    // Returns a unique index of the card in [0, gCardNumber) range - suit
+    // major, rank minor.
+    constexpr u32 value() const {
+      return value_;
+    }
+
+    // Inverse of `value()`.
+    static constexpr Card FromValue(u32 value) {
+      assert(value < gCardNumber);
+      Card card;
+      card.value_ = static_cast<u8>(value);
+      return card;
+    }
 
   private:
-    Suit suit_{};
-    Rank rank_{};
+    u8 value_{};
 };
 
+static_assert(sizeof(Card) == 1);
+static_assert(std::is_trivially_copyable_v<Card>);
+
 } // namespace model
 
 #endif // !COMMON_MODEL_CARD_H_
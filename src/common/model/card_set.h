@@ -0,0 +1,173 @@
+#ifndef COMMON_MODEL_CARD_SET_H_
+#define COMMON_MODEL_CARD_SET_H_
+
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card.h"
+
+namespace model {
+
+// `CardSet` models an unordered collection of distinct cards as a 64 bit mask.
+// The card occupies the bit number `Card::value()`, so every suit is a run of
+// 13 bits ordered by rank: spades 0-12, clubs 13-25, diamonds 26-38 and hearts
+// 39-51. Set operations are single bitwise instructions and nothing is ever
+// allocated.
+class CardSet {
+  public:
+    // Iterates over the cards of the set in the order of `Card::value()`.
+    class Iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Card;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr Iterator() = default;
+        constexpr explicit Iterator(u64 bits) : bits_(bits) {
+        }
+
+        constexpr Card operator*() const {
+          return Card::FromValue(std::countr_zero(bits_));
+        }
+
+        constexpr Iterator& operator++() {
+          bits_ &= bits_ - 1;
+          return *this;
+        }
+
+        constexpr Iterator operator++(int) {
+          Iterator previous = *this;
+          ++*this;
+          return previous;
+        }
+
+        constexpr bool operator==(const Iterator& other) const = default;
+
+      private:
+        u64 bits_{0};
+    };
+
+    static constexpr u64 kAllCardsMask = (u64{1} << gCardNumber) - 1;
+    static constexpr u32 kSuitMask = (1u << gRankNumber) - 1;
+
+    constexpr CardSet() = default;
+    constexpr explicit CardSet(u64 bits) : bits_(bits & kAllCardsMask) {
+    }
+    constexpr CardSet(std::initializer_list<Card> cards) {
+      for (Card card : cards) {
+        Insert(card);
+      }
+    }
+    constexpr explicit CardSet(std::span<const Card> cards) {
+      for (Card card : cards) {
+        Insert(card);
+      }
+    }
+
+    static constexpr CardSet FromValue(u32 value) {
+      return CardSet{u64{1} << value};
+    }
+
+    // All 52 cards.
+    static constexpr CardSet Full() {
+      return CardSet{kAllCardsMask};
+    }
+
+    constexpr u64 bits() const {
+      return bits_;
+    }
+
+    constexpr u32 Size() const {
+      return std::popcount(bits_);
+    }
+
+    constexpr bool Empty() const {
+      return bits_ == 0;
+    }
+
+    constexpr bool ContainsValue(u32 value) const {
+      return (bits_ >> value) & 1;
+    }
+
+    constexpr bool Contains(Card card) const {
+      return ContainsValue(card.value());
+    }
+
+    // Whether every card of `other` is in this set.
+    constexpr bool ContainsAll(CardSet other) const {
+      return (bits_ & other.bits_) == other.bits_;
+    }
+
+    constexpr bool Intersects(CardSet other) const {
+      return (bits_ & other.bits_) != 0;
+    }
+
+    constexpr void Insert(Card card) {
+      bits_ |= u64{1} << card.value();
+    }
+
+    constexpr void Erase(Card card) {
+      bits_ &= ~(u64{1} << card.value());
+    }
+
+    // 13 bit mask of the ranks of the `suit` cards, bit n stands for the rank
+    // n.
+    constexpr u32 SuitMask(Card::Suit suit) const {
+      return static_cast<u32>(bits_ >> (static_cast<u32>(suit) * gRankNumber)) &
+             kSuitMask;
+    }
+
+    constexpr CardSet operator|(CardSet other) const {
+      return CardSet{bits_ | other.bits_};
+    }
+
+    constexpr CardSet operator&(CardSet other) const {
+      return CardSet{bits_ & other.bits_};
+    }
+
+    // Cards of this set that are not in `other`.
+    constexpr CardSet operator-(CardSet other) const {
+      return CardSet{bits_ & ~other.bits_};
+    }
+
+    // Cards that are not in this set.
+    constexpr CardSet operator~() const {
+      return CardSet{~bits_};
+    }
+
+    constexpr CardSet& operator|=(CardSet other) {
+      bits_ |= other.bits_;
+      return *this;
+    }
+
+    constexpr CardSet& operator&=(CardSet other) {
+      bits_ &= other.bits_;
+      return *this;
+    }
+
+    constexpr CardSet& operator-=(CardSet other) {
+      bits_ &= ~other.bits_;
+      return *this;
+    }
+
+    constexpr bool operator==(const CardSet& other) const = default;
+
+    constexpr Iterator begin() const {
+      return Iterator{bits_};
+    }
+
+    constexpr Iterator end() const {
+      return Iterator{};
+    }
+
+  private:
+    u64 bits_{0};
+};
+
+} // namespace model
+
+#endif // !COMMON_MODEL_CARD_SET_H_
@@ -0,0 +1,101 @@
+#include "model/hand_range.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+
+namespace model {
+
+namespace {
+
+// Combination -> its two cards.
+constexpr std::array<u64, gComboNumber> kComboCards = [] {
+  std::array<u64, gComboNumber> cards{};
+  for (u32 high{1}; high < gCardNumber; high++) {
+    for (u32 low{}; low < high; low++) {
+      cards[HandRange::ComboIndex(low, high)] =
+        (u64{1} << low) | (u64{1} << high);
+    }
+  }
+  return cards;
+}();
+
+// Card value -> the combinations containing the card.
+constexpr std::array<std::array<u16, gCardNumber - 1>, gCardNumber>
+  kCardCombos = [] {
+    std::array<std::array<u16, gCardNumber - 1>, gCardNumber> combos{};
+    for (u32 card{}; card < gCardNumber; card++) {
+      u32 count = 0;
+      for (u32 other{}; other < gCardNumber; other++) {
+        if (other != card) {
+          combos[card][count++] = HandRange::ComboIndex(
+            std::min(card, other), std::max(card, other));
+        }
+      }
+    }
+    return combos;
+  }();
+
+} // namespace
+
+CardSet HandRange::ComboCards(u32 combo) {
+  return CardSet{kComboCards[combo]};
+}
+
+void HandRange::SetWeight(CardSet cards, f32 weight) {
+  assert(cards.Size() == 2);
+  const u32 low = std::countr_zero(cards.bits());
+  const u32 high = std::bit_width(cards.bits()) - 1;
+  SetWeight(ComboIndex(low, high), weight);
+}
+
+void HandRange::SetWeight(u32 combo, f32 weight) {
+  assert(weight >= 0.0f && weight <= 1.0f);
+  const bool removed = weights_[combo] > 0.0f && weight == 0.0f;
+  weights_[combo] = weight;
+  if (removed) {
+    UpdateCards();
+  } else if (weight > 0.0f) {
+    cards_ |= ComboCards(combo);
+  }
+}
+
+void HandRange::RemoveCards(CardSet dead) {
+  if (!cards_.Intersects(dead)) {
+    return;
+  }
+  for (u64 bits{(cards_ & dead).bits()}; bits; bits &= bits - 1) {
+    for (u16 combo : kCardCombos[std::countr_zero(bits)]) {
+      weights_[combo] = 0.0f;
+    }
+  }
+  UpdateCards();
+}
+
+HandRange HandRange::WithoutCards(CardSet dead) const {
+  HandRange range = *this;
+  range.RemoveCards(dead);
+  return range;
+}
+
+u32 HandRange::Size() const {
+  return std::ranges::count_if(weights_,
+                               [](f32 weight) { return weight > 0.0f; });
+}
+
+void HandRange::UpdateCards() {
+  u64 bits = 0;
+  for (u32 combo{}; combo < gComboNumber; combo++) {
+    if (weights_[combo] > 0.0f) {
+      bits |= kComboCards[combo];
+    }
+  }
+  cards_ = CardSet{bits};
+}
+
+} // namespace model
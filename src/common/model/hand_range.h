@@ -0,0 +1,69 @@
+#ifndef COMMON_MODEL_HAND_RANGE_H_
+#define COMMON_MODEL_HAND_RANGE_H_
+
+#include <array>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+
+namespace model {
+
+// Number of distinct pairs of hole cards.
+constexpr u32 gComboNumber = gCardNumber * (gCardNumber - 1) / 2;
+
+// `HandRange` is a weighted set of hole card combinations, e.g. the hands an
+// opponent is believed to hold. Every one of the 1326 combinations has a
+// weight in [0, 1] stored in a dense array, and the mask of the cards used by
+// the combinations with a non-zero weight is kept next to it, so removing
+// known cards and iterating over the range never touch `Card` objects.
+//
+// Combinations are indexed by the values of their cards: the combination of
+// the cards `low` < `high` has the index high * (high - 1) / 2 + low.
+class HandRange {
+  public:
+    static constexpr u32 ComboIndex(u32 low_value, u32 high_value) {
+      return high_value * (high_value - 1) / 2 + low_value;
+    }
+
+    static CardSet ComboCards(u32 combo);
+
+    std::span<const f32, gComboNumber> weights() const {
+      return weights_;
+    }
+
+    f32 Weight(u32 combo) const {
+      return weights_[combo];
+    }
+
+    // `cards` must be two cards.
+    void SetWeight(CardSet cards, f32 weight);
+    void SetWeight(u32 combo, f32 weight);
+
+    // Cards of the combinations with a non-zero weight.
+    CardSet Cards() const {
+      return cards_;
+    }
+
+    // Drops the combinations that use any of `dead`, e.g. the board.
+    void RemoveCards(CardSet dead);
+    HandRange WithoutCards(CardSet dead) const;
+
+    // Number of combinations with a non-zero weight.
+    u32 Size() const;
+
+    bool Empty() const {
+      return cards_.Empty();
+    }
+
+  private:
+    void UpdateCards();
+
+    std::array<f32, gComboNumber> weights_{};
+    CardSet cards_;
+};
+
+} // namespace model
+
+#endif // !COMMON_MODEL_HAND_RANGE_H_
@@ -0,0 +1,76 @@
+#include "model/suit_canonicalizer.h"
+
+#include <array>
+#include <span>
+#include <utility>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+
+namespace model {
+
+SuitPermutation::SuitPermutation()
+  : suits_{Card::Suit::kSpades, Card::Suit::kClubs, Card::Suit::kDiamonds,
+           Card::Suit::kHearts} {
+}
+
+CardSet SuitPermutation::Apply(CardSet cards) const {
+  u64 bits = 0;
+  for (u32 suit{}; suit < gSuitNumber; suit++) {
+    const u64 mask = cards.SuitMask(static_cast<Card::Suit>(suit));
+    bits |= mask << (static_cast<u32>(suits_[suit]) * gRankNumber);
+  }
+  return CardSet{bits};
+}
+
+SuitPermutation SuitPermutation::Inverse() const {
+  std::array<Card::Suit, gSuitNumber> inverse{};
+  for (u32 suit{}; suit < gSuitNumber; suit++) {
+    inverse[static_cast<u32>(suits_[suit])] = static_cast<Card::Suit>(suit);
+  }
+  return SuitPermutation{inverse};
+}
+
+CanonicalHand SuitCanonicalizer::Canonicalize(CardSet hole_cards,
+                                              CardSet board) {
+  const std::array groups = {hole_cards, board};
+  const SuitPermutation permutation = CanonicalPermutation(groups);
+  return {
+    .hole_cards = permutation.Apply(hole_cards),
+    .board = permutation.Apply(board),
+    .permutation = permutation,
+  };
+}
+
+SuitPermutation
+SuitCanonicalizer::CanonicalPermutation(std::span<const CardSet> groups) {
+  // Whether the suit `a` comes before the suit `b`: the one with higher ranks
+  // in the first group where they differ.
+  auto precedes = [groups](u32 a, u32 b) {
+    for (CardSet group : groups) {
+      const u32 a_mask = group.SuitMask(static_cast<Card::Suit>(a));
+      const u32 b_mask = group.SuitMask(static_cast<Card::Suit>(b));
+      if (a_mask != b_mask) {
+        return a_mask > b_mask;
+      }
+    }
+    return false;
+  };
+
+  std::array<u32, gSuitNumber> order{0, 1, 2, 3};
+  // Insertion sort, there are 4 suits.
+  for (u32 i{1}; i < gSuitNumber; i++) {
+    for (u32 j{i}; j && precedes(order[j], order[j - 1]); j--) {
+      std::swap(order[j - 1], order[j]);
+    }
+  }
+
+  std::array<Card::Suit, gSuitNumber> suits{};
+  for (u32 position{}; position < gSuitNumber; position++) {
+    suits[order[position]] = static_cast<Card::Suit>(position);
+  }
+  return SuitPermutation{suits};
+}
+
+} // namespace model
@@ -0,0 +1,75 @@
+#ifndef COMMON_MODEL_SUIT_CANONICALIZER_H_
+#define COMMON_MODEL_SUIT_CANONICALIZER_H_
+
+#include <array>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+
+namespace model {
+
+// `SuitPermutation` renames suits, e.g. turns every heart into a spade and
+// every spade into a heart. Hand strengths, equities and everything else that
+// does not look at suit names stay the same under any permutation.
+class SuitPermutation {
+  public:
+    // The identity.
+    SuitPermutation();
+    explicit SuitPermutation(const std::array<Card::Suit, gSuitNumber>& suits)
+      : suits_(suits) {
+    }
+
+    Card::Suit Apply(Card::Suit suit) const {
+      return suits_[static_cast<u32>(suit)];
+    }
+
+    Card Apply(Card card) const {
+      return Card{Apply(card.suit()), card.rank()};
+    }
+
+    CardSet Apply(CardSet cards) const;
+
+    SuitPermutation Inverse() const;
+
+    bool operator==(const SuitPermutation& other) const = default;
+
+  private:
+    // Original suit -> new suit.
+    std::array<Card::Suit, gSuitNumber> suits_;
+};
+
+// Hole cards and board renamed to the canonical suits, together with the
+// permutation that does it. `permutation.Inverse()` maps results computed for
+// the canonical hand back to the original suits.
+struct CanonicalHand {
+    CardSet hole_cards;
+    CardSet board;
+    SuitPermutation permutation;
+};
+
+// `SuitCanonicalizer` picks one representative out of every class of
+// (hole cards, board) pairs that differ only by suit names. Suits are ordered
+// by their hole cards first and their board cards second, and renamed in that
+// order to spades, clubs, diamonds and hearts. Suits with the same cards in
+// both are interchangeable, so the order among them does not matter.
+//
+// Preflop the 1326 hole card combinations fall into 169 classes, with a flop
+// the number of cases drops about 20 times.
+class SuitCanonicalizer {
+  public:
+    static CanonicalHand Canonicalize(CardSet hole_cards, CardSet board = {});
+
+    // Generalization to any ordered list of groups of cards, e.g. the hole
+    // cards of every player followed by the board and the dead cards. Suits
+    // are ordered by their cards in the first group, then in the second one
+    // and so on, so the permutation is the same for any two lists that differ
+    // only by suit names.
+    static SuitPermutation
+    CanonicalPermutation(std::span<const CardSet> groups);
+};
+
+} // namespace model
+
+#endif // !COMMON_MODEL_SUIT_CANONICALIZER_H_
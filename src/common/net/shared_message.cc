@@ -0,0 +1,15 @@
+#include "net/shared_message.h"
+
+#include <memory>
+
+#include "net/wire_protocol.h"
+
+namespace common::net {
+
+SharedMessage::SharedMessage(const Message& message)
+  : encodings_(std::make_shared<const Encodings>(
+      Encodings{.text = EncodeText(message),
+                .binary = Encode(message, WireFormat::kBinary)})) {
+}
+
+} // namespace common::net
@@ -0,0 +1,39 @@
+#ifndef COMMON_NET_SHARED_MESSAGE_H_
+#define COMMON_NET_SHARED_MESSAGE_H_
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "net/wire_protocol.h"
+
+namespace common::net {
+
+// `SharedMessage` is a message encoded once in every wire format, for sending
+// the same event to many recipients. The encodings are immutable and
+// reference counted, so copies are cheap and every send path can hold on to
+// them, and fanning a message out costs no encoding or allocation per
+// recipient.
+class SharedMessage {
+  public:
+    explicit SharedMessage(const Message& message);
+
+    // The message encoded in `format`, valid as long as a copy of this object
+    // exists.
+    std::string_view Get(WireFormat format) const {
+      return format == WireFormat::kBinary ? encodings_->binary
+                                           : encodings_->text;
+    }
+
+  private:
+    struct Encodings {
+        std::string text;
+        std::string binary;
+    };
+
+    std::shared_ptr<const Encodings> encodings_;
+};
+
+} // namespace common::net
+
+#endif // !COMMON_NET_SHARED_MESSAGE_H_
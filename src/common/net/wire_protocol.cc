@@ -0,0 +1,478 @@
+#include "net/wire_protocol.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <expected>
+#include <format>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "utility/card_serializer.h"
+
+namespace common::net {
+
+namespace {
+
+constexpr u32 kCardBits = 6;
+constexpr u32 kMaxVarintBytes = 10;
+
+// Appends fields of a frame to a string.
+class WireWriter {
+  public:
+    explicit WireWriter(std::string& out) : out_(out) {
+    }
+
+    void Byte(u8 value) {
+      out_.push_back(static_cast<char>(value));
+    }
+
+    void Varint(u64 value) {
+      for (; value >= 0x80; value >>= 7) {
+        Byte(static_cast<u8>(value | 0x80));
+      }
+      Byte(static_cast<u8>(value));
+    }
+
+    // The count of the cards followed by their values, 6 bits each.
+    void Cards(std::span<const model::Card> cards) {
+      Byte(static_cast<u8>(cards.size()));
+      u32 bits = 0;
+      u32 bit_count = 0;
+      for (model::Card card : cards) {
+        bits |= card.value() << bit_count;
+        bit_count += kCardBits;
+        for (; bit_count >= 8; bit_count -= 8, bits >>= 8) {
+          Byte(static_cast<u8>(bits));
+        }
+      }
+      if (bit_count) {
+        Byte(static_cast<u8>(bits));
+      }
+    }
+
+    void String(std::string_view text) {
+      Varint(text.size());
+      out_.append(text);
+    }
+
+  private:
+    std::string& out_;
+};
+
+// Reads fields of a frame, the counterpart of `WireWriter`.
+class WireReader {
+  public:
+    explicit WireReader(std::string_view data) : data_(data) {
+    }
+
+    std::expected<u8, WireError> Byte() {
+      if (position_ == data_.size()) {
+        return std::unexpected(WireError::kTruncated);
+      }
+      return static_cast<u8>(data_[position_++]);
+    }
+
+    // Only the shortest encoding of a value is accepted, so every message
+    // has exactly one encoding.
+    std::expected<u64, WireError> Varint() {
+      u64 value = 0;
+      for (u32 i{}; i < kMaxVarintBytes; i++) {
+        const std::expected<u8, WireError> byte = Byte();
+        if (!byte) {
+          return std::unexpected(byte.error());
+        }
+        // The last byte holds bit 63 only, and a final zero byte after the
+        // first one only makes the encoding longer.
+        if ((i == kMaxVarintBytes - 1 && *byte > 1) || (i && !*byte)) {
+          return std::unexpected(WireError::kMalformed);
+        }
+        value |= static_cast<u64>(*byte & 0x7F) << (7 * i);
+        if (!(*byte & 0x80)) {
+          return value;
+        }
+      }
+      return std::unexpected(WireError::kMalformed);
+    }
+
+    // Reads the cards into `out` and returns their count, which must not
+    // exceed its size.
+    std::expected<u8, WireError> Cards(std::span<model::Card> out) {
+      const std::expected<u8, WireError> count = Byte();
+      if (!count) {
+        return count;
+      }
+      if (*count > out.size()) {
+        return std::unexpected(WireError::kMalformed);
+      }
+      u32 bits = 0;
+      u32 bit_count = 0;
+      for (u32 i{}; i < *count; i++) {
+        if (bit_count < kCardBits) {
+          const std::expected<u8, WireError> byte = Byte();
+          if (!byte) {
+            return std::unexpected(byte.error());
+          }
+          bits |= static_cast<u32>(*byte) << bit_count;
+          bit_count += 8;
+        }
+        const u32 value = bits & ((1u << kCardBits) - 1);
+        if (value >= model::gCardNumber) {
+          return std::unexpected(WireError::kMalformed);
+        }
+        out[i] = model::Card::FromValue(value);
+        bits >>= kCardBits;
+        bit_count -= kCardBits;
+      }
+      // The padding after the last card must be zero.
+      if (bits) {
+        return std::unexpected(WireError::kMalformed);
+      }
+      return count;
+    }
+
+    std::expected<std::string, WireError> String() {
+      const std::expected<u64, WireError> size = Varint();
+      if (!size) {
+        return std::unexpected(size.error());
+      }
+      if (*size > data_.size() - position_) {
+        return std::unexpected(WireError::kTruncated);
+      }
+      std::string text(data_.substr(position_, *size));
+      position_ += *size;
+      return text;
+    }
+
+    bool AtEnd() const {
+      return position_ == data_.size();
+    }
+
+    std::size_t position() const {
+      return position_;
+    }
+
+  private:
+    std::string_view data_;
+    std::size_t position_{0};
+};
+
+void EncodeFields(const WelcomeMessage& message, WireWriter& writer) {
+  writer.Byte(message.protocol_version);
+  writer.Varint(message.player_id);
+}
+
+void EncodeFields(const GameFinishedMessage& message, WireWriter& writer) {
+  writer.Byte(static_cast<u8>(message.reason));
+}
+
+void EncodeFields(const HoleCardsMessage& message, WireWriter& writer) {
+  writer.Cards(message.cards);
+}
+
+void EncodeFields(const BoardMessage& message, WireWriter& writer) {
+  writer.Cards(std::span(message.cards).first(message.size));
+}
+
+void EncodeFields(const StackMessage& message, WireWriter& writer) {
+  writer.Varint(message.player_id);
+  writer.Varint(message.chips);
+}
+
+void EncodeFields(const TextMessage& message, WireWriter& writer) {
+  writer.String(message.text);
+}
+
+void EncodeFields(const ActionMessage& message, WireWriter& writer) {
+  writer.Byte(static_cast<u8>(message.kind));
+  writer.Varint(message.amount);
+}
+
+std::expected<Message, WireError> DecodeFields(MessageType type,
+                                               WireReader& reader) {
+  switch (type) {
+  case MessageType::kWelcome: {
+    const std::expected<u8, WireError> version = reader.Byte();
+    if (!version) {
+      return std::unexpected(version.error());
+    }
+    const std::expected<u64, WireError> player_id = reader.Varint();
+    if (!player_id) {
+      return std::unexpected(player_id.error());
+    }
+    return WelcomeMessage{.protocol_version = *version,
+                          .player_id = *player_id};
+  }
+  case MessageType::kGameFinished: {
+    const std::expected<u8, WireError> reason = reader.Byte();
+    if (!reason) {
+      return std::unexpected(reason.error());
+    }
+    if (*reason > static_cast<u8>(GameFinishReason::kPlayerLeft)) {
+      return std::unexpected(WireError::kMalformed);
+    }
+    return GameFinishedMessage{.reason =
+                                 static_cast<GameFinishReason>(*reason)};
+  }
+  case MessageType::kHoleCards: {
+    HoleCardsMessage message;
+    const std::expected<u8, WireError> count = reader.Cards(message.cards);
+    if (!count) {
+      return std::unexpected(count.error());
+    }
+    if (*count != message.cards.size()) {
+      return std::unexpected(WireError::kMalformed);
+    }
+    return message;
+  }
+  case MessageType::kBoard: {
+    BoardMessage message;
+    const std::expected<u8, WireError> count = reader.Cards(message.cards);
+    if (!count) {
+      return std::unexpected(count.error());
+    }
+    message.size = *count;
+    return message;
+  }
+  case MessageType::kStack: {
+    const std::expected<u64, WireError> player_id = reader.Varint();
+    if (!player_id) {
+      return std::unexpected(player_id.error());
+    }
+    const std::expected<u64, WireError> chips = reader.Varint();
+    if (!chips) {
+      return std::unexpected(chips.error());
+    }
+    return StackMessage{.player_id = *player_id, .chips = *chips};
+  }
+  case MessageType::kText: {
+    std::expected<std::string, WireError> text = reader.String();
+    if (!text) {
+      return std::unexpected(text.error());
+    }
+    return TextMessage{.text = *std::move(text)};
+  }
+  case MessageType::kAction: {
+    const std::expected<u8, WireError> kind = reader.Byte();
+    if (!kind) {
+      return std::unexpected(kind.error());
+    }
+    if (*kind > static_cast<u8>(ActionKind::kRaise)) {
+      return std::unexpected(WireError::kMalformed);
+    }
+    const std::expected<u64, WireError> amount = reader.Varint();
+    if (!amount) {
+      return std::unexpected(amount.error());
+    }
+    return ActionMessage{.kind = static_cast<ActionKind>(*kind),
+                         .amount = *amount};
+  }
+  }
+  return std::unexpected(WireError::kUnknownType);
+}
+
+std::string_view FinishReasonToString(GameFinishReason reason) {
+  switch (reason) {
+  case GameFinishReason::kNormal:
+    return "The game has finished normally";
+  case GameFinishReason::kServerFinished:
+    return "The server has forced the game to finish";
+  case GameFinishReason::kPlayerLeft:
+    return "A player has left";
+  }
+  return "Undefined reason";
+}
+
+// Indexed by `ActionKind`.
+constexpr std::array<std::string_view, 5> kActionNames = {"fold", "check",
+                                                          "call", "bet",
+                                                          "raise"};
+
+bool HasAmount(ActionKind kind) {
+  return kind == ActionKind::kBet || kind == ActionKind::kRaise;
+}
+
+std::expected<ActionMessage, WireError> ParseTextAction(std::string_view text) {
+  const std::size_t space = text.find(' ');
+  const std::string_view name = text.substr(0, space);
+  const auto found = std::ranges::find(kActionNames, name);
+  if (found == kActionNames.end()) {
+    return std::unexpected(WireError::kUnknownType);
+  }
+  ActionMessage action{
+    .kind = static_cast<ActionKind>(found - kActionNames.begin())};
+  if (!HasAmount(action.kind)) {
+    if (space != std::string_view::npos) {
+      return std::unexpected(WireError::kMalformed);
+    }
+    return action;
+  }
+  if (space == std::string_view::npos) {
+    return std::unexpected(WireError::kMalformed);
+  }
+  const std::string_view amount = text.substr(space + 1);
+  const auto [end, error] = std::from_chars(
+    amount.data(), amount.data() + amount.size(), action.amount, 10);
+  if (error != std::errc{} || end != amount.data() + amount.size()) {
+    return std::unexpected(WireError::kMalformed);
+  }
+  return action;
+}
+
+std::string CardsToString(std::span<const model::Card> cards) {
+  std::string text(cards.size() * utility::CardSerializer::kCardLength, '\0');
+  char* out = text.data();
+  for (model::Card card : cards) {
+    out = utility::CardSerializer::SerializeTo(card, out);
+  }
+  return text;
+}
+
+// Whether `list`, separated by `separator`, has `item` with surrounding
+// spaces trimmed.
+bool ListContains(std::string_view list, char separator,
+                  std::string_view item) {
+  while (!list.empty()) {
+    const std::size_t end = list.find(separator);
+    std::string_view element = list.substr(0, end);
+    const std::size_t first = element.find_first_not_of(' ');
+    if (first != std::string_view::npos) {
+      const std::size_t last = element.find_last_not_of(' ');
+      element = element.substr(first, last - first + 1);
+      if (element == item) {
+        return true;
+      }
+    }
+    if (end == std::string_view::npos) {
+      break;
+    }
+    list.remove_prefix(end + 1);
+  }
+  return false;
+}
+
+} // namespace
+
+WireFormat NegotiateWireFormat(std::string_view uri,
+                               std::string_view subprotocols) {
+  const std::size_t query = uri.find('?');
+  if (query != std::string_view::npos &&
+      ListContains(uri.substr(query + 1), '&', "wire=binary")) {
+    return WireFormat::kBinary;
+  }
+  if (ListContains(subprotocols, ',', gBinarySubprotocol)) {
+    return WireFormat::kBinary;
+  }
+  return WireFormat::kText;
+}
+
+void EncodeFrame(const Message& message, std::string& out) {
+  const std::size_t start = out.size();
+  WireWriter writer(out);
+  std::visit(
+    [&writer](const auto& typed) {
+      writer.Byte(static_cast<u8>(typed.kType));
+      EncodeFields(typed, writer);
+    },
+    message);
+
+  // The length goes in front of the frame once it is known.
+  std::string length;
+  WireWriter(length).Varint(out.size() - start);
+  out.insert(start, length);
+}
+
+std::expected<DecodedFrame, WireError> DecodeFrame(std::string_view data) {
+  WireReader header(data);
+  const std::expected<u64, WireError> length = header.Varint();
+  if (!length) {
+    return std::unexpected(length.error());
+  }
+  if (*length > data.size() - header.position()) {
+    return std::unexpected(WireError::kTruncated);
+  }
+
+  WireReader reader(data.substr(header.position(), *length));
+  const std::expected<u8, WireError> type = reader.Byte();
+  if (!type) {
+    return std::unexpected(WireError::kMalformed);
+  }
+  std::expected<Message, WireError> message =
+    DecodeFields(static_cast<MessageType>(*type), reader);
+  if (!message) {
+    // The frame is complete, so running out of it means a bad field.
+    return std::unexpected(message.error() == WireError::kTruncated
+                             ? WireError::kMalformed
+                             : message.error());
+  }
+  if (!reader.AtEnd()) {
+    return std::unexpected(WireError::kMalformed);
+  }
+  return DecodedFrame{.message = *std::move(message),
+                      .size = header.position() + *length};
+}
+
+std::string EncodeText(const Message& message) {
+  return std::visit(
+    [](const auto& typed) -> std::string {
+      using Type = std::decay_t<decltype(typed)>;
+      if constexpr (std::is_same_v<Type, WelcomeMessage>) {
+        return std::format("Welcome to the game player: {}", typed.player_id);
+      } else if constexpr (std::is_same_v<Type, GameFinishedMessage>) {
+        return std::string(FinishReasonToString(typed.reason));
+      } else if constexpr (std::is_same_v<Type, HoleCardsMessage>) {
+        return std::format("Hole cards: {}", CardsToString(typed.cards));
+      } else if constexpr (std::is_same_v<Type, BoardMessage>) {
+        return std::format(
+          "Board: {}", CardsToString(std::span(typed.cards).first(typed.size)));
+      } else if constexpr (std::is_same_v<Type, StackMessage>) {
+        return std::format("Player {} has {} chips", typed.player_id,
+                           typed.chips);
+      } else if constexpr (std::is_same_v<Type, ActionMessage>) {
+        const std::string_view name =
+          kActionNames[static_cast<u8>(typed.kind)];
+        return HasAmount(typed.kind) ? std::format("{} {}", name, typed.amount)
+                                     : std::string(name);
+      } else {
+        return typed.text;
+      }
+    },
+    message);
+}
+
+std::string Encode(const Message& message, WireFormat format) {
+  if (format == WireFormat::kText) {
+    return EncodeText(message);
+  }
+  std::string frame;
+  EncodeFrame(message, frame);
+  return frame;
+}
+
+std::expected<ActionMessage, WireError> DecodeAction(std::string_view data,
+                                                     WireFormat format) {
+  if (format == WireFormat::kText) {
+    return ParseTextAction(data);
+  }
+  const std::expected<DecodedFrame, WireError> frame = DecodeFrame(data);
+  if (!frame) {
+    return std::unexpected(frame.error());
+  }
+  if (frame->size != data.size()) {
+    return std::unexpected(WireError::kMalformed);
+  }
+  const ActionMessage* action = std::get_if<ActionMessage>(&frame->message);
+  if (!action) {
+    return std::unexpected(WireError::kUnknownType);
+  }
+  return *action;
+}
+
+} // namespace common::net
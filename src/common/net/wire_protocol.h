@@ -0,0 +1,148 @@
+#ifndef COMMON_NET_WIRE_PROTOCOL_H_
+#define COMMON_NET_WIRE_PROTOCOL_H_
+
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "aliasing.h"
+#include "model/card.h"
+
+// Messages the server sends to players and their two encodings: readable
+// text, and compact binary frames for clients that ask for them.
+//
+// A binary frame is the length of the rest of the frame as a varint, a
+// `MessageType` tag and the fields of the message. Integers are LEB128
+// varints, so chip amounts and ids take as many bytes as they need. Cards are
+// 6 bit `Card::value()` indices packed 4 to 3 bytes, after a byte with their
+// count. A WebSocket message may carry several frames.
+//
+// The format of a connection is picked by the client when it connects, with
+// the query parameter "wire=binary" in the URI or the subprotocol
+// `gBinarySubprotocol`. Anything else gets text. Players send their actions
+// in the same format, one `ActionMessage` per WebSocket message.
+namespace common::net {
+
+inline constexpr u8 gWireProtocolVersion = 1;
+
+inline constexpr std::string_view gBinarySubprotocol = "poker.binary.v1";
+
+enum class WireFormat : u8 {
+  kText,
+  kBinary,
+};
+
+enum class MessageType : u8 {
+  kWelcome = 1,
+  kGameFinished = 2,
+  kHoleCards = 3,
+  kBoard = 4,
+  kStack = 5,
+  kText = 6,
+  kAction = 7,
+};
+
+enum class GameFinishReason : u8 {
+  kNormal = 0,
+  kServerFinished = 1,
+  kPlayerLeft = 2,
+};
+
+struct WelcomeMessage {
+    static constexpr MessageType kType = MessageType::kWelcome;
+    u8 protocol_version{gWireProtocolVersion};
+    u64 player_id{};
+};
+
+struct GameFinishedMessage {
+    static constexpr MessageType kType = MessageType::kGameFinished;
+    GameFinishReason reason{};
+};
+
+struct HoleCardsMessage {
+    static constexpr MessageType kType = MessageType::kHoleCards;
+    std::array<model::Card, 2> cards{};
+};
+
+struct BoardMessage {
+    static constexpr MessageType kType = MessageType::kBoard;
+    // Cards in the order they were dealt, the first `size` are valid.
+    std::array<model::Card, 5> cards{};
+    u8 size{};
+};
+
+struct StackMessage {
+    static constexpr MessageType kType = MessageType::kStack;
+    u64 player_id{};
+    u64 chips{};
+};
+
+// Anything without a message of its own.
+struct TextMessage {
+    static constexpr MessageType kType = MessageType::kText;
+    std::string text;
+};
+
+enum class ActionKind : u8 {
+  kFold = 0,
+  kCheck = 1,
+  kCall = 2,
+  kBet = 3,
+  kRaise = 4,
+};
+
+// An action of a player, the only message clients send. In text it is the
+// lower case name of the kind followed by the amount for bets and raises,
+// e.g. "raise 200".
+struct ActionMessage {
+    static constexpr MessageType kType = MessageType::kAction;
+    ActionKind kind{};
+    // Chips, for `kBet` and `kRaise` only.
+    u64 amount{};
+};
+
+using Message = std::variant<WelcomeMessage, GameFinishedMessage,
+                             HoleCardsMessage, BoardMessage, StackMessage,
+                             TextMessage, ActionMessage>;
+
+enum class WireError : u8 {
+  // The data ends in the middle of a frame.
+  kTruncated,
+  kUnknownType,
+  // A field is out of its range or the frame has bytes left over.
+  kMalformed,
+};
+
+struct DecodedFrame {
+    Message message;
+    // Bytes of the frame, the next one starts right after them.
+    std::size_t size{};
+};
+
+// Picks the format of a connection from the URI of its opening request and
+// its Sec-WebSocket-Protocol header, a comma separated list.
+WireFormat NegotiateWireFormat(std::string_view uri,
+                               std::string_view subprotocols);
+
+// Appends the binary frame of `message` to `out`.
+void EncodeFrame(const Message& message, std::string& out);
+
+// Decodes the frame at the start of `data`.
+std::expected<DecodedFrame, WireError> DecodeFrame(std::string_view data);
+
+// Readable form of `message`, for text connections and logs.
+std::string EncodeText(const Message& message);
+
+// Encodes `message` in `format`.
+std::string Encode(const Message& message, WireFormat format);
+
+// Parses an action a player sent in `format`, a whole WebSocket message.
+std::expected<ActionMessage, WireError> DecodeAction(std::string_view data,
+                                                     WireFormat format);
+
+} // namespace common::net
+
+#endif // !COMMON_NET_WIRE_PROTOCOL_H_
@@ -1,141 +1,162 @@
 #include "card_serializer.h"
 
-#include <exception>
-#include <format>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <expected>
 #include <optional>
-#include <print>
+#include <span>
 #include <string>
 #include <string_view>
 
+#include "aliasing.h"
 #include "model/card.h"
+#include "model/card_set.h"
 
 namespace common::utility {
 
 namespace {
 
-model::Card::Suit CharToSuit(char character) {
-  using Suit = model::Card::Suit;
-  switch (character) {
-  case 'S':
-    return Suit::kSpades;
-  case 'C':
-    return Suit::kClubs;
-  case 'D':
-    return Suit::kDiamonds;
-  case 'H':
-    return Suit::kHearts;
-  default:
-    throw std::exception("Could not parse the character to suit");
+// Characters indexed by `Card::Suit` and `Card::Rank`.
+constexpr std::string_view kSuitCharacters = "SCDH";
+constexpr std::string_view kRankCharacters = "23456789TJQKA";
+
+constexpr u8 kInvalid = 0xFF;
+
+// Character -> index of it in `characters`, or `kInvalid`.
+constexpr std::array<u8, 256> MakeDecodeTable(std::string_view characters) {
+  std::array<u8, 256> table{};
+  table.fill(kInvalid);
+  for (u32 i{}; i < characters.size(); i++) {
+    table[static_cast<u8>(characters[i])] = static_cast<u8>(i);
   }
+  return table;
 }
 
-model::Card::Rank CharToRank(char character) {
-  using Rank = model::Card::Rank;
-  switch (character) {
-  case '2':
-    return Rank::kTwo;
-  case '3':
-    return Rank::kThree;
-  case '4':
-    return Rank::kFour;
-  case '5':
-    return Rank::kFive;
-  case '6':
-    return Rank::kSix;
-  case '7':
-    return Rank::kSeven;
-  case '8':
-    return Rank::kEighth;
-  case '9':
-    return Rank::kNine;
-  case 'T':
-    return Rank::kTen;
-  case 'A':
-    return Rank::kAce;
-  case 'J':
-    return Rank::kJack;
-  case 'Q':
-    return Rank::kQueen;
-  case 'K':
-    return Rank::kKing;
-  default:
-    throw std::exception{};
+constexpr std::array<u8, 256> kSuitTable = MakeDecodeTable(kSuitCharacters);
+constexpr std::array<u8, 256> kRankTable = MakeDecodeTable(kRankCharacters);
+
+// `Card::value()` -> both characters of the card.
+constexpr std::array<std::array<char, CardSerializer::kCardLength>,
+                     model::gCardNumber>
+  kCardTexts = [] {
+    std::array<std::array<char, CardSerializer::kCardLength>,
+               model::gCardNumber>
+      texts{};
+    for (u32 value{}; value < model::gCardNumber; value++) {
+      texts[value] = {kSuitCharacters[value / model::gRankNumber],
+                      kRankCharacters[value % model::gRankNumber]};
+    }
+    return texts;
+  }();
+
+// Decodes the two characters at `data`.
+std::expected<model::Card, SerializationError> DecodeCard(const char* data) {
+  const u8 suit = kSuitTable[static_cast<u8>(data[0])];
+  if (suit == kInvalid) {
+    return std::unexpected(SerializationError::kInvalidSuit);
   }
+  const u8 rank = kRankTable[static_cast<u8>(data[1])];
+  if (rank == kInvalid) {
+    return std::unexpected(SerializationError::kInvalidRank);
+  }
+  return model::Card::FromValue(suit * model::gRankNumber + rank);
 }
 
-char SuitToChar(model::Card::Suit suit) {
-  using Suit = model::Card::Suit;
-  switch (suit) {
-  case Suit::kSpades:
-    return 'S';
-  case Suit::kClubs:
-    return 'C';
-  case Suit::kDiamonds:
-    return 'D';
-  case Suit::kHearts:
-    return 'H';
-  }
+} // namespace
+
+char* CardSerializer::SerializeTo(model::Card card, char* out) {
+  std::memcpy(out, kCardTexts[card.value()].data(), kCardLength);
+  return out + kCardLength;
 }
 
-char RankToChar(model::Card::Rank rank) {
-  using Rank = model::Card::Rank;
-  switch (rank) {
-  case Rank::kTwo:
-    return '2';
-  case Rank::kThree:
-    return '3';
-  case Rank::kFour:
-    return '4';
-  case Rank::kFive:
-    return '5';
-  case Rank::kSix:
-    return '6';
-  case Rank::kSeven:
-    return '7';
-  case Rank::kEighth:
-    return '8';
-  case Rank::kNine:
-    return '9';
-  case Rank::kTen:
-    return 'T';
-  case Rank::kAce:
-    return 'A';
-  case Rank::kJack:
-    return 'J';
-  case Rank::kQueen:
-    return 'Q';
-  case Rank::kKing:
-    return 'K';
+char* CardSerializer::SerializeTo(model::CardSet cards, char* out) {
+  for (model::Card card : cards) {
+    out = SerializeTo(card, out);
   }
+  return out;
 }
 
-} // namespace
+std::string CardSerializer::Serialize(model::Card card) {
+  return std::string(kCardTexts[card.value()].data(), kCardLength);
+}
 
-std::string CardSerializer::Serialize(const model::Card& card) {
-  return std::format("{}{}", SuitToChar(card.suit()), RankToChar(card.rank()));
+std::string CardSerializer::Serialize(model::CardSet cards) {
+  std::string result(cards.Size() * kCardLength, '\0');
+  SerializeTo(cards, result.data());
+  return result;
 }
 
-std::optional<model::Card> CardSerializer::Deserialize(std::string_view data) {
-  if (data.length() != 2) {
-    return std::nullopt;
+std::expected<model::Card, SerializationError>
+CardSerializer::Deserialize(std::string_view data) {
+  if (data.length() != kCardLength) {
+    return std::unexpected(SerializationError::kWrongLength);
   }
+  return DecodeCard(data.data());
+}
 
-  model::Card::Suit suit{};
-  model::Card::Rank rank{};
-  try {
-    suit = CharToSuit(data.at(0));
-  } catch (const std::exception& e) {
-    std::print("Could not parse character \"{}\"to suit.\n", data.at(0));
+std::optional<model::Card::Rank>
+CardSerializer::DeserializeRank(char character) {
+  const u8 rank = kRankTable[static_cast<u8>(character)];
+  if (rank == kInvalid) {
     return std::nullopt;
   }
+  return static_cast<model::Card::Rank>(rank);
+}
 
-  try {
-    rank = CharToRank(data.at(1));
-  } catch (const std::exception& e) {
-    std::print("Could not parse character \"{}\"to rank.\n", data.at(0));
-    return std::nullopt;
+std::expected<model::CardSet, SerializationError>
+CardSerializer::DeserializeCardSet(std::string_view data) {
+  if (data.length() % kCardLength != 0) {
+    return std::unexpected(SerializationError::kWrongLength);
+  }
+
+  model::CardSet cards;
+  for (std::size_t i{}; i < data.length(); i += kCardLength) {
+    const std::expected<model::Card, SerializationError> card =
+      DecodeCard(data.data() + i);
+    if (!card) {
+      return std::unexpected(card.error());
+    }
+    if (cards.Contains(*card)) {
+      return std::unexpected(SerializationError::kDuplicateCard);
+    }
+    cards.Insert(*card);
+  }
+  return cards;
+}
+
+std::expected<std::size_t, SerializationError>
+CardSerializer::SerializeHand(std::span<const model::Card> cards,
+                              std::span<char> out) {
+  if (out.size() < cards.size() * kCardLength) {
+    return std::unexpected(SerializationError::kBufferTooSmall);
+  }
+  char* end = out.data();
+  for (model::Card card : cards) {
+    end = SerializeTo(card, end);
+  }
+  return cards.size() * kCardLength;
+}
+
+std::expected<std::size_t, SerializationError>
+CardSerializer::DeserializeHand(std::string_view data,
+                                std::span<model::Card> out) {
+  if (data.length() % kCardLength != 0) {
+    return std::unexpected(SerializationError::kWrongLength);
+  }
+  const std::size_t count = data.length() / kCardLength;
+  if (out.size() < count) {
+    return std::unexpected(SerializationError::kBufferTooSmall);
+  }
+  for (std::size_t i{}; i < count; i++) {
+    const std::expected<model::Card, SerializationError> card =
+      DecodeCard(data.data() + i * kCardLength);
+    if (!card) {
+      return std::unexpected(card.error());
+    }
+    out[i] = *card;
   }
-  return model::Card{suit, rank};
+  return count;
 }
 
 } // namespace common::utility
@@ -1,26 +1,93 @@
 #ifndef COMMON_CARD_SERIALIZER_H_
 #define COMMON_CARD_SERIALIZER_H_
 
+#include <cstddef>
+#include <expected>
+#include <format>
 #include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 
+#include "aliasing.h"
 #include "model/card.h"
+#include "model/card_set.h"
 
 namespace common::utility {
 
+enum class SerializationError : u8 {
+  // The text is not a whole number of cards.
+  kWrongLength,
+  kInvalidSuit,
+  kInvalidRank,
+  // A set of cards contains the same card twice.
+  kDuplicateCard,
+  // The output buffer cannot hold all cards.
+  kBufferTooSmall,
+};
+
 // `CardSerializer` is a utility class that serializes and deserializes `Card`
-// objects.
+// objects. A card is two characters, the suit and the rank, e.g. "HT" for the
+// ten of hearts.
+//
+// Both directions are table lookups. Nothing throws and, apart from the
+// variants returning a `std::string`, nothing allocates, so malformed input
+// coming from clients costs no more than valid input.
 class CardSerializer {
   public:
+    static constexpr std::size_t kCardLength = 2;
+
+    // Writes the two characters of `card` to `out` and returns the end of
+    // them.
+    static char* SerializeTo(model::Card card, char* out);
+
+    // Writes the cards of `cards` in the order of `Card::value()` to `out`,
+    // which must hold `cards.Size() * kCardLength` characters, and returns
+    // the end of them.
+    static char* SerializeTo(model::CardSet cards, char* out);
+
     // Serializes a card to a string.
-    static std::string Serialize(const model::Card& card);
+    static std::string Serialize(model::Card card);
+
+    // Serializes a set of cards to a string of concatenated cards, in the
+    // order of `Card::value()`.
+    static std::string Serialize(model::CardSet cards);
 
-    // Deserializes a card from a string. If string is malformed or has
-    // incorrect data an std::nullopt is returned.
-    static std::optional<model::Card> Deserialize(std::string_view data);
+    // Deserializes a card from a string.
+    static std::expected<model::Card, SerializationError>
+    Deserialize(std::string_view data);
+
+    // Deserializes the rank character of a card, e.g. 'T' for a ten.
+    static std::optional<model::Card::Rank> DeserializeRank(char character);
+
+    // Deserializes a set of cards from concatenated cards.
+    static std::expected<model::CardSet, SerializationError>
+    DeserializeCardSet(std::string_view data);
+
+    // Writes the cards of a hand or a board to `out` in their order. Returns
+    // the number of characters written.
+    static std::expected<std::size_t, SerializationError>
+    SerializeHand(std::span<const model::Card> cards, std::span<char> out);
+
+    // Reads concatenated cards into `out` in their order. Returns the number
+    // of cards read. Nothing is checked for duplicates.
+    static std::expected<std::size_t, SerializationError>
+    DeserializeHand(std::string_view data, std::span<model::Card> out);
 };
 
 } // namespace common::utility
 
+// Formats a card as `CardSerializer` does, e.g.
+// std::format_to(out, "{} wins", card).
+template <>
+struct std::formatter<model::Card> : std::formatter<std::string_view> {
+    template <class FormatContext>
+    auto format(model::Card card, FormatContext& context) const {
+      char text[common::utility::CardSerializer::kCardLength];
+      common::utility::CardSerializer::SerializeTo(card, text);
+      return std::formatter<std::string_view>::format(
+        std::string_view(text, sizeof(text)), context);
+    }
+};
+
 #endif // !COMMON_CARD_SERIALIZER_H_
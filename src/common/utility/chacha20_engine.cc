@@ -0,0 +1,80 @@
+#include "utility/chacha20_engine.h"
+
+#include <array>
+#include <bit>
+#include <random>
+
+#include "aliasing.h"
+#include "utility/random_engine.h"
+
+namespace common::utility {
+
+namespace {
+
+// "expand 32-byte k" in little endian words.
+constexpr std::array<u32, 4> kConstants = {0x61707865, 0x3320646E, 0x79622D32,
+                                           0x6B206574};
+
+void QuarterRound(std::array<u32, 16>& x, u32 a, u32 b, u32 c, u32 d) {
+  x[a] += x[b];
+  x[d] = std::rotl(x[d] ^ x[a], 16);
+  x[c] += x[d];
+  x[b] = std::rotl(x[b] ^ x[c], 12);
+  x[a] += x[b];
+  x[d] = std::rotl(x[d] ^ x[a], 8);
+  x[c] += x[d];
+  x[b] = std::rotl(x[b] ^ x[c], 7);
+}
+
+} // namespace
+
+ChaCha20Engine::ChaCha20Engine(const Key& key, u64 nonce, u64 counter) {
+  for (u32 i{}; i < kConstants.size(); i++) {
+    state_[i] = kConstants[i];
+  }
+  for (u32 i{}; i < key.size(); i++) {
+    state_[4 + i] = key[i];
+  }
+  state_[12] = static_cast<u32>(counter);
+  state_[13] = static_cast<u32>(counter >> 32);
+  state_[14] = static_cast<u32>(nonce);
+  state_[15] = static_cast<u32>(nonce >> 32);
+}
+
+ChaCha20Engine ChaCha20Engine::FromEntropy() {
+  std::random_device device;
+  Key key;
+  for (u32& word : key) {
+    word = device();
+  }
+  return ChaCha20Engine{key};
+}
+
+void ChaCha20Engine::Refill() {
+  for (u32 block{}; block < kBufferBlocks; block++) {
+    std::array<u32, kBlockWords> x = state_;
+    for (u32 round{}; round < 10; round++) {
+      QuarterRound(x, 0, 4, 8, 12);
+      QuarterRound(x, 1, 5, 9, 13);
+      QuarterRound(x, 2, 6, 10, 14);
+      QuarterRound(x, 3, 7, 11, 15);
+      QuarterRound(x, 0, 5, 10, 15);
+      QuarterRound(x, 1, 6, 11, 12);
+      QuarterRound(x, 2, 7, 8, 13);
+      QuarterRound(x, 3, 4, 9, 14);
+    }
+    // Words of the keystream are paired in their byte order.
+    for (u32 i{}; i < kBlockWords; i += 2) {
+      const u64 low = x[i] + state_[i];
+      const u64 high = x[i + 1] + state_[i + 1];
+      buffer_[(block * kBlockWords + i) / 2] =
+        low | (static_cast<u64>(static_cast<u32>(high)) << 32);
+    }
+    if (++state_[12] == 0) {
+      state_[13]++;
+    }
+  }
+  position_ = 0;
+}
+
+} // namespace common::utility
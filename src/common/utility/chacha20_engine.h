@@ -0,0 +1,64 @@
+#ifndef COMMON_UTILITY_CHACHA20_ENGINE_H_
+#define COMMON_UTILITY_CHACHA20_ENGINE_H_
+
+#include <array>
+#include <limits>
+
+#include "aliasing.h"
+#include "utility/random_engine.h"
+
+namespace common::utility {
+
+// `ChaCha20Engine` is a cryptographically secure generator: the keystream of
+// the ChaCha20 stream cipher under a random 256 bit key. Its output cannot be
+// told apart from true randomness nor used to predict the next card, which is
+// what dealing games for real money needs.
+//
+// Blocks are generated several at a time into a buffer, so most calls only
+// read a word out of it.
+class ChaCha20Engine {
+  public:
+    using result_type = u64;
+    using Key = std::array<u32, 8>;
+
+    // Keystream of `key` with the 64 bit `nonce`, starting at the block
+    // `counter`. With a fixed key the output is reproducible, which tests use.
+    explicit ChaCha20Engine(const Key& key, u64 nonce = 0, u64 counter = 0);
+
+    // Keyed from `std::random_device`.
+    static ChaCha20Engine FromEntropy();
+
+    static constexpr result_type min() {
+      return 0;
+    }
+
+    static constexpr result_type max() {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+      if (position_ == kBufferWords) {
+        Refill();
+      }
+      return buffer_[position_++];
+    }
+
+  private:
+    static constexpr u32 kBlockWords = 16;
+    static constexpr u32 kBufferBlocks = 4;
+    static constexpr u32 kBufferWords = kBufferBlocks * kBlockWords / 2;
+
+    // Generates the next `kBufferBlocks` blocks of the keystream.
+    void Refill();
+
+    // Constants, key, block counter (words 12 and 13) and nonce.
+    std::array<u32, kBlockWords> state_;
+    std::array<u64, kBufferWords> buffer_;
+    u32 position_{kBufferWords};
+};
+
+static_assert(RandomEngine<ChaCha20Engine>);
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_CHACHA20_ENGINE_H_
@@ -0,0 +1,53 @@
+#ifndef COMMON_UTILITY_CPU_FEATURES_H_
+#define COMMON_UTILITY_CPU_FEATURES_H_
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+// `CpuFeatures` answers which optional instruction sets can be used on the
+// machine the program runs on, so hot loops can pick a vectorized kernel at
+// runtime instead of at compile time. Results are computed once.
+class CpuFeatures {
+  public:
+    // AVX2 requires both the CPU support and the OS saving the YMM registers.
+    static bool HasAvx2() {
+      static const bool has_avx2 = DetectAvx2();
+      return has_avx2;
+    }
+
+  private:
+    static bool DetectAvx2() {
+#if defined(__x86_64__) || defined(__i386__)
+      unsigned eax{}, ebx{}, ecx{}, edx{};
+      if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+      }
+      if (!(ecx & bit_OSXSAVE) || !(ecx & bit_AVX)) {
+        return false;
+      }
+
+      u32 xcr0_low{}, xcr0_high{};
+      __asm__("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+      // Bit 1 - SSE state, bit 2 - AVX state.
+      if ((xcr0_low & 0b110) != 0b110) {
+        return false;
+      }
+
+      if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+        return false;
+      }
+      return ebx & bit_AVX2;
+#else
+      return false;
+#endif
+    }
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_CPU_FEATURES_H_
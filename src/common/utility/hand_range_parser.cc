@@ -0,0 +1,194 @@
+#include "hand_range_parser.h"
+
+#include <algorithm>
+#include <charconv>
+#include <expected>
+#include <optional>
+#include <string_view>
+#include <system_error>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/hand_range.h"
+#include "utility/card_serializer.h"
+
+namespace common::utility {
+
+namespace {
+
+using model::Card;
+using model::CardSet;
+
+enum class Suitedness {
+  kPair,
+  kSuited,
+  kOffsuit,
+  kAny,
+};
+
+// A hand like "AKs", without the card suits.
+struct Hand {
+    u32 high;
+    u32 low;
+    Suitedness suitedness;
+};
+
+std::string_view Trim(std::string_view text) {
+  const std::size_t first = text.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  const std::size_t last = text.find_last_not_of(" \t");
+  return text.substr(first, last - first + 1);
+}
+
+std::optional<Hand> ParseHand(std::string_view text) {
+  if (text.length() != 2 && text.length() != 3) {
+    return std::nullopt;
+  }
+  const std::optional<Card::Rank> first =
+    CardSerializer::DeserializeRank(text[0]);
+  const std::optional<Card::Rank> second =
+    CardSerializer::DeserializeRank(text[1]);
+  if (!first || !second) {
+    return std::nullopt;
+  }
+
+  Hand hand{
+    .high = std::max(static_cast<u32>(*first), static_cast<u32>(*second)),
+    .low = std::min(static_cast<u32>(*first), static_cast<u32>(*second)),
+    .suitedness = Suitedness::kAny,
+  };
+  if (hand.high == hand.low) {
+    hand.suitedness = Suitedness::kPair;
+    return text.length() == 2 ? std::optional{hand} : std::nullopt;
+  }
+  if (text.length() == 3) {
+    if (text[2] == 's') {
+      hand.suitedness = Suitedness::kSuited;
+    } else if (text[2] == 'o') {
+      hand.suitedness = Suitedness::kOffsuit;
+    } else {
+      return std::nullopt;
+    }
+  }
+  return hand;
+}
+
+// Sets the weight of every combination of `hand`.
+void AddHand(const Hand& hand, f32 weight, model::HandRange& range) {
+  for (u32 high_suit{}; high_suit < model::gSuitNumber; high_suit++) {
+    for (u32 low_suit{}; low_suit < model::gSuitNumber; low_suit++) {
+      const bool suited = high_suit == low_suit;
+      if ((hand.suitedness == Suitedness::kPair && low_suit <= high_suit) ||
+          (hand.suitedness == Suitedness::kSuited && !suited) ||
+          (hand.suitedness == Suitedness::kOffsuit && suited)) {
+        continue;
+      }
+      range.SetWeight(
+        CardSet::FromValue(high_suit * model::gRankNumber + hand.high) |
+          CardSet::FromValue(low_suit * model::gRankNumber + hand.low),
+        weight);
+    }
+  }
+}
+
+// Parses an item without its weight.
+bool ParseItem(std::string_view item, f32 weight, model::HandRange& range) {
+  // Hands start with a rank, single combinations with a suit.
+  if (item.length() == 4 && !CardSerializer::DeserializeRank(item[0])) {
+    const std::expected<CardSet, SerializationError> combo =
+      CardSerializer::DeserializeCardSet(item);
+    if (!combo) {
+      return false;
+    }
+    range.SetWeight(*combo, weight);
+    return true;
+  }
+
+  if (item.ends_with('+')) {
+    std::optional<Hand> hand = ParseHand(item.substr(0, item.length() - 1));
+    if (!hand) {
+      return false;
+    }
+    if (hand->suitedness == Suitedness::kPair) {
+      for (; hand->high < model::gRankNumber; hand->high++, hand->low++) {
+        AddHand(*hand, weight, range);
+      }
+    } else {
+      for (; hand->low < hand->high; hand->low++) {
+        AddHand(*hand, weight, range);
+      }
+    }
+    return true;
+  }
+
+  const std::size_t dash = item.find('-');
+  if (dash != std::string_view::npos) {
+    const std::optional<Hand> from = ParseHand(item.substr(0, dash));
+    const std::optional<Hand> to = ParseHand(item.substr(dash + 1));
+    if (!from || !to || from->suitedness != to->suitedness) {
+      return false;
+    }
+    if (from->suitedness == Suitedness::kPair) {
+      for (u32 rank{std::min(from->high, to->high)};
+           rank <= std::max(from->high, to->high); rank++) {
+        AddHand({rank, rank, Suitedness::kPair}, weight, range);
+      }
+      return true;
+    }
+    if (from->high != to->high) {
+      return false;
+    }
+    for (u32 low{std::min(from->low, to->low)};
+         low <= std::max(from->low, to->low); low++) {
+      AddHand({from->high, low, from->suitedness}, weight, range);
+    }
+    return true;
+  }
+
+  const std::optional<Hand> hand = ParseHand(item);
+  if (!hand) {
+    return false;
+  }
+  AddHand(*hand, weight, range);
+  return true;
+}
+
+} // namespace
+
+std::optional<model::HandRange>
+HandRangeParser::Parse(std::string_view notation) {
+  model::HandRange range;
+  // Set after a comma, so that an empty item at the end is rejected too.
+  bool item_expected = false;
+  while (!notation.empty() || item_expected) {
+    const std::size_t comma = notation.find(',');
+    std::string_view item = Trim(notation.substr(0, comma));
+    item_expected = comma != std::string_view::npos;
+    notation = item_expected ? notation.substr(comma + 1) : std::string_view{};
+
+    f32 weight = 1.0f;
+    const std::size_t colon = item.find(':');
+    if (colon != std::string_view::npos) {
+      const std::string_view weight_text = Trim(item.substr(colon + 1));
+      const auto [end, error] = std::from_chars(
+        weight_text.data(), weight_text.data() + weight_text.size(), weight);
+      // Written so that NaN, which compares false to everything, fails too.
+      if (error != std::errc{} ||
+          end != weight_text.data() + weight_text.size() ||
+          !(weight > 0.0f && weight <= 1.0f)) {
+        return std::nullopt;
+      }
+      item = Trim(item.substr(0, colon));
+    }
+
+    if (!ParseItem(item, weight, range)) {
+      return std::nullopt;
+    }
+  }
+  return range;
+}
+
+} // namespace common::utility
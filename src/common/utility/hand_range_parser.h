@@ -0,0 +1,30 @@
+#ifndef COMMON_UTILITY_HAND_RANGE_PARSER_H_
+#define COMMON_UTILITY_HAND_RANGE_PARSER_H_
+
+#include <optional>
+#include <string_view>
+
+#include "model/hand_range.h"
+
+namespace common::utility {
+
+// `HandRangeParser` compiles the usual range notation into a `HandRange`.
+// A range is a comma separated list of:
+//   "QQ"        a pair,
+//   "AKs" "AKo" a suited or offsuit hand, "AK" for both,
+//   "TT+"       a pair and all higher pairs,
+//   "AQs+"      a hand and the ones with a higher kicker, up to "AKs",
+//   "22-55"     pairs between the two, inclusive,
+//   "A2s-A5s"   hands with the same high card and kickers between the two,
+//   "SAHK"      one combination, in the notation of `CardSerializer`.
+// Any item can end with ":<weight>", a weight in (0, 1], 1 by default. Ranks
+// are written as in `CardSerializer`. When items overlap the later one wins.
+class HandRangeParser {
+  public:
+    // Returns nullopt if the notation is malformed.
+    static std::optional<model::HandRange> Parse(std::string_view notation);
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_HAND_RANGE_PARSER_H_
@@ -0,0 +1,174 @@
+#include "logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+namespace {
+
+using namespace std::literals::chrono_literals;
+
+// How long the logger thread sleeps when there was nothing to write.
+constexpr auto kIdleInterval = 5ms;
+
+std::string_view LevelName(LogLevel level) {
+  switch (level) {
+  case LogLevel::kDebug:
+    return "DEBUG";
+  case LogLevel::kInfo:
+    return "INFO";
+  case LogLevel::kWarning:
+    return "WARNING";
+  case LogLevel::kError:
+    return "ERROR";
+  }
+  return "?";
+}
+
+void AppendPrefix(std::chrono::steady_clock::time_point start,
+                  std::chrono::steady_clock::duration time, LogLevel level,
+                  std::string& out) {
+  const std::chrono::duration<double> seconds = time - start.time_since_epoch();
+  std::format_to(std::back_inserter(out), "[{:.6f}] [{}] ", seconds.count(),
+                 LevelName(level));
+}
+
+// Registers the buffer of a thread on its first log call and hands the buffer
+// over to the logger when the thread exits.
+class ThreadBufferHandle {
+  public:
+    ThreadBufferHandle() {
+      auto buffer = std::make_unique<log_internal::LogBuffer>();
+      buffer_ = buffer.get();
+      Logger::Instance().Register(std::move(buffer));
+    }
+    ~ThreadBufferHandle() {
+      buffer_->abandoned.store(true, std::memory_order_release);
+    }
+    ThreadBufferHandle(const ThreadBufferHandle&) = delete;
+    void operator=(const ThreadBufferHandle&) = delete;
+
+    log_internal::LogBuffer& buffer() {
+      return *buffer_;
+    }
+
+  private:
+    log_internal::LogBuffer* buffer_;
+};
+
+} // namespace
+
+namespace log_internal {
+
+u32 LogBuffer::Drain(std::chrono::steady_clock::time_point start,
+                     std::string& out) {
+  const u32 head = head_.load(std::memory_order_relaxed);
+  const u32 tail = tail_.load(std::memory_order_acquire);
+  for (u32 i = head; i != tail; i++) {
+    const LogRecord& record = records_[i % kCapacity];
+    AppendPrefix(start, std::chrono::steady_clock::duration(record.time),
+                 record.level, out);
+    record.format_function(record, out);
+    out.push_back('\n');
+  }
+  head_.store(tail, std::memory_order_release);
+  return tail - head;
+}
+
+LogBuffer& ThreadLogBuffer() {
+  thread_local ThreadBufferHandle handle;
+  return handle.buffer();
+}
+
+} // namespace log_internal
+
+Logger& Logger::Instance() {
+  static Logger logger;
+  return logger;
+}
+
+Logger::Logger()
+  : start_(std::chrono::steady_clock::now()),
+    thread_([this](std::stop_token stop_token) { Run(stop_token); }) {
+}
+
+Logger::~Logger() {
+  thread_.request_stop();
+  thread_.join();
+  DrainAll();
+}
+
+void Logger::Flush() {
+  DrainAll();
+}
+
+void Logger::Register(std::unique_ptr<log_internal::LogBuffer> buffer) {
+  std::lock_guard lock{buffers_mutex_};
+  buffers_.push_back(std::move(buffer));
+}
+
+void Logger::Run(std::stop_token stop_token) {
+  while (!stop_token.stop_requested()) {
+    if (!DrainAll()) {
+      std::unique_lock lock{wake_mutex_};
+      wake_.wait_for(lock, stop_token, kIdleInterval, [] { return false; });
+    }
+  }
+}
+
+bool Logger::DrainAll() {
+  std::lock_guard drain_lock{drain_mutex_};
+  // Buffers are only freed here, so they can be drained without holding
+  // `buffers_mutex_` and threads logging for the first time do not wait.
+  {
+    std::lock_guard lock{buffers_mutex_};
+    snapshot_.clear();
+    for (const std::unique_ptr<log_internal::LogBuffer>& buffer : buffers_) {
+      snapshot_.push_back(buffer.get());
+    }
+  }
+
+  u32 drained = 0;
+  bool any_abandoned = false;
+  for (log_internal::LogBuffer* buffer : snapshot_) {
+    // Read before draining, so what the thread logged before exiting is
+    // drained too.
+    const bool abandoned = buffer->abandoned.load(std::memory_order_acquire);
+    drained += buffer->Drain(start_, output_);
+    if (const u64 dropped = buffer->TakeDropped()) {
+      AppendPrefix(start_, std::chrono::steady_clock::now().time_since_epoch(),
+                   LogLevel::kWarning, output_);
+      std::format_to(std::back_inserter(output_), "{} log records dropped\n",
+                     dropped);
+    }
+    any_abandoned |= abandoned;
+  }
+
+  if (any_abandoned) {
+    std::lock_guard lock{buffers_mutex_};
+    std::erase_if(buffers_, [](const auto& buffer) {
+      return buffer->abandoned.load(std::memory_order_acquire) &&
+             buffer->Empty();
+    });
+  }
+
+  if (!output_.empty()) {
+    std::fwrite(output_.data(), 1, output_.size(), stdout);
+    std::fflush(stdout);
+    output_.clear();
+  }
+  return drained > 0;
+}
+
+} // namespace common::utility
@@ -0,0 +1,276 @@
+#ifndef COMMON_UTILITY_LOGGER_H_
+#define COMMON_UTILITY_LOGGER_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aliasing.h"
+
+// Asynchronous logging. A call to `LogInfo` and friends copies the format
+// string view, a timestamp and the arguments into a ring buffer owned by the
+// calling thread and returns; formatting and writing to stdout happen on the
+// thread of `Logger`. A full buffer drops the record and counts it, so a
+// burst never blocks the caller, and the drops are reported once the logger
+// catches up.
+//
+// Levels below `gMinLogLevel` compile to nothing. Arguments are copied by
+// value, so they must be trivially copyable or convertible to
+// `std::string_view`; strings are copied, and cut when a record is full.
+namespace common::utility {
+
+enum class LogLevel : u8 {
+  kDebug,
+  kInfo,
+  kWarning,
+  kError,
+};
+
+#ifdef DEBUG_MODE
+inline constexpr LogLevel gMinLogLevel = LogLevel::kDebug;
+#else
+inline constexpr LogLevel gMinLogLevel = LogLevel::kInfo;
+#endif
+
+namespace log_internal {
+
+// One log call. Records take whole cache lines, so the producer writing one
+// and the logger thread reading the one before it do not share a line.
+struct alignas(64) LogRecord {
+    using FormatFunction = void (*)(const LogRecord& record, std::string& out);
+
+    static constexpr std::size_t kPayloadSize = 88;
+
+    FormatFunction format_function;
+    std::string_view format;
+    std::chrono::steady_clock::rep time;
+    LogLevel level;
+    std::array<std::byte, kPayloadSize> payload;
+};
+static_assert(sizeof(LogRecord) == 128);
+
+// Single producer, single consumer ring of records. The producer is the
+// thread the buffer belongs to, the consumer the logger thread.
+class LogBuffer {
+  public:
+    static constexpr u32 kCapacity = 256;
+
+    // The slot for the next record, or nullptr after counting a drop if the
+    // buffer is full. `Commit` publishes the slot.
+    LogRecord* Reserve() {
+      const u32 tail = tail_.load(std::memory_order_relaxed);
+      if (tail - head_.load(std::memory_order_acquire) == kCapacity) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+      return &records_[tail % kCapacity];
+    }
+
+    void Commit() {
+      tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_release);
+    }
+
+    // Formats the pending records as lines with their time since `start`,
+    // appends them to `out` and removes them. Returns how many there were.
+    u32 Drain(std::chrono::steady_clock::time_point start, std::string& out);
+
+    bool Empty() const {
+      return head_.load(std::memory_order_acquire) ==
+             tail_.load(std::memory_order_acquire);
+    }
+
+    u64 TakeDropped() {
+      return dropped_.exchange(0, std::memory_order_relaxed);
+    }
+
+    // Set when the owning thread exits; the logger frees the buffer once it
+    // is drained.
+    std::atomic_bool abandoned{false};
+
+  private:
+    std::array<LogRecord, kCapacity> records_;
+    alignas(64) std::atomic<u32> head_{0};
+    alignas(64) std::atomic<u32> tail_{0};
+    std::atomic<u64> dropped_{0};
+};
+
+// The buffer of the calling thread, registered with the logger on first use.
+LogBuffer& ThreadLogBuffer();
+
+template <class T>
+concept StringLike = std::convertible_to<const T&, std::string_view>;
+
+// How an argument of type `T` is kept in a record.
+template <class T>
+using Stored = std::conditional_t<StringLike<T>, std::string_view, T>;
+
+template <class T>
+constexpr std::size_t gFixedSize = StringLike<T> ? sizeof(u16) : sizeof(T);
+
+template <class T>
+std::byte* Encode(const T& value, std::byte* out, const std::byte* end) {
+  if constexpr (StringLike<T>) {
+    const std::string_view text = value;
+    const u16 size = static_cast<u16>(std::min<std::size_t>(
+      text.size(), static_cast<std::size_t>(end - out) - sizeof(u16)));
+    std::memcpy(out, &size, sizeof(size));
+    std::memcpy(out + sizeof(size), text.data(), size);
+    return out + sizeof(size) + size;
+  } else {
+    std::memcpy(out, &value, sizeof(T));
+    return out + sizeof(T);
+  }
+}
+
+template <class T>
+Stored<T> Decode(const std::byte*& in) {
+  if constexpr (StringLike<T>) {
+    u16 size;
+    std::memcpy(&size, in, sizeof(size));
+    const std::string_view text(
+      reinterpret_cast<const char*>(in + sizeof(size)), size);
+    in += sizeof(size) + size;
+    return text;
+  } else {
+    T value;
+    std::memcpy(&value, in, sizeof(T));
+    in += sizeof(T);
+    return value;
+  }
+}
+
+template <class... Args>
+void FormatRecord(const LogRecord& record, std::string& out) {
+  [[maybe_unused]] const std::byte* in = record.payload.data();
+  // Braces evaluate the decodes in order.
+  const std::tuple<Stored<Args>...> values{Decode<Args>(in)...};
+  std::apply(
+    [&record, &out](const auto&... arguments) {
+      std::vformat_to(std::back_inserter(out), record.format,
+                      std::make_format_args(arguments...));
+    },
+    values);
+}
+
+template <class... Args>
+void Write(LogLevel level, std::string_view format, const Args&... args) {
+  static_assert(((StringLike<Args> || std::is_trivially_copyable_v<Args>) &&
+                 ...),
+                "Log arguments are copied into the record");
+  static_assert((gFixedSize<Args> + ... + 0) <= LogRecord::kPayloadSize,
+                "Log arguments do not fit a record");
+
+  LogBuffer& buffer = ThreadLogBuffer();
+  LogRecord* record = buffer.Reserve();
+  if (!record) {
+    return;
+  }
+  record->format_function = &FormatRecord<Args...>;
+  record->format = format;
+  record->time = std::chrono::steady_clock::now().time_since_epoch().count();
+  record->level = level;
+
+  // Strings get what the fixed size arguments after them leave over.
+  [[maybe_unused]] std::byte* out = record->payload.data();
+  [[maybe_unused]] std::size_t fixed_after = (gFixedSize<Args> + ... + 0);
+  (
+    [&] {
+      fixed_after -= gFixedSize<Args>;
+      out = Encode(args, out,
+                   record->payload.data() + record->payload.size() -
+                     fixed_after);
+    }(),
+    ...);
+  buffer.Commit();
+}
+
+} // namespace log_internal
+
+// `Logger` owns the thread that formats records and writes them to stdout.
+// It starts on first use and writes out what is left when the program exits.
+class Logger {
+  public:
+    static Logger& Instance();
+
+    Logger(const Logger&) = delete;
+    void operator=(const Logger&) = delete;
+
+    // Writes the records logged before the call.
+    void Flush();
+
+    void Register(std::unique_ptr<log_internal::LogBuffer> buffer);
+
+  private:
+    Logger();
+    ~Logger();
+
+    void Run(std::stop_token stop_token);
+
+    // Writes the pending records of all buffers and frees the abandoned ones.
+    // Returns whether there were any records.
+    bool DrainAll();
+
+    // Held while draining, so `Flush` and the thread do not drain at once.
+    std::mutex drain_mutex_;
+    std::string output_;
+    std::vector<log_internal::LogBuffer*> snapshot_;
+
+    std::mutex buffers_mutex_;
+    std::vector<std::unique_ptr<log_internal::LogBuffer>> buffers_;
+
+    std::chrono::steady_clock::time_point start_;
+
+    std::mutex wake_mutex_;
+    std::condition_variable_any wake_;
+
+    // Declared last, so the thread stops before the buffers are destroyed.
+    std::jthread thread_;
+};
+
+template <LogLevel level, class... Args>
+void Log(std::format_string<const Args&...> format, const Args&... args) {
+  if constexpr (level >= gMinLogLevel) {
+    log_internal::Write(level, format.get(), args...);
+  }
+}
+
+template <class... Args>
+void LogDebug(std::format_string<const Args&...> format, const Args&... args) {
+  Log<LogLevel::kDebug, Args...>(format, args...);
+}
+
+template <class... Args>
+void LogInfo(std::format_string<const Args&...> format, const Args&... args) {
+  Log<LogLevel::kInfo, Args...>(format, args...);
+}
+
+template <class... Args>
+void LogWarning(std::format_string<const Args&...> format,
+                const Args&... args) {
+  Log<LogLevel::kWarning, Args...>(format, args...);
+}
+
+template <class... Args>
+void LogError(std::format_string<const Args&...> format, const Args&... args) {
+  Log<LogLevel::kError, Args...>(format, args...);
+}
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_LOGGER_H_
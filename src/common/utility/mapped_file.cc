@@ -0,0 +1,101 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+namespace common::utility {
+
+#ifdef _WIN32
+
+std::unique_ptr<MappedFile>
+MappedFile::Open(const std::filesystem::path& path) {
+  std::unique_ptr<MappedFile> file{new MappedFile()};
+
+  file->file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file->file_ == INVALID_HANDLE_VALUE) {
+    file->file_ = nullptr;
+    return nullptr;
+  }
+
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(file->file_, &size) || size.QuadPart == 0) {
+    return nullptr;
+  }
+
+  file->mapping_ =
+    CreateFileMappingW(file->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!file->mapping_) {
+    return nullptr;
+  }
+
+  const void* view = MapViewOfFile(file->mapping_, FILE_MAP_READ, 0, 0, 0);
+  if (!view) {
+    return nullptr;
+  }
+  file->data_ = static_cast<const std::byte*>(view);
+  file->size_ = static_cast<std::size_t>(size.QuadPart);
+  return file;
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+  if (file_) {
+    CloseHandle(file_);
+  }
+}
+
+#else
+
+std::unique_ptr<MappedFile>
+MappedFile::Open(const std::filesystem::path& path) {
+  const int descriptor = open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    return nullptr;
+  }
+
+  struct stat status{};
+  if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+    close(descriptor);
+    return nullptr;
+  }
+
+  void* view = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, descriptor,
+                    0);
+  // The mapping keeps the file alive on its own.
+  close(descriptor);
+  if (view == MAP_FAILED) {
+    return nullptr;
+  }
+
+  std::unique_ptr<MappedFile> file{new MappedFile()};
+  file->data_ = static_cast<const std::byte*>(view);
+  file->size_ = static_cast<std::size_t>(status.st_size);
+  return file;
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(const_cast<std::byte*>(data_), size_);
+  }
+}
+
+#endif
+
+} // namespace common::utility
@@ -0,0 +1,46 @@
+#ifndef COMMON_UTILITY_MAPPED_FILE_H_
+#define COMMON_UTILITY_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <span>
+
+namespace common::utility {
+
+// `MappedFile` maps a whole file into the address space of the process,
+// read-only. Pages are loaded lazily by the OS and shared between all
+// processes mapping the same file, so large precomputed tables cost neither
+// startup time nor private memory. The mapping lives as long as the object.
+class MappedFile {
+  public:
+    // Returns nullptr if the file cannot be opened or mapped.
+    static std::unique_ptr<MappedFile> Open(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+    void operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    void operator=(MappedFile&&) = delete;
+
+    ~MappedFile();
+
+    std::span<const std::byte> data() const {
+      return {data_, size_};
+    }
+
+  private:
+    MappedFile() = default;
+
+    const std::byte* data_{nullptr};
+    std::size_t size_{0};
+
+#ifdef _WIN32
+    // HANDLE values, kept as void* so windows.h does not leak out of here.
+    void* file_{nullptr};
+    void* mapping_{nullptr};
+#endif
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_MAPPED_FILE_H_
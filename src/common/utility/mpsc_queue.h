@@ -0,0 +1,95 @@
+#ifndef COMMON_UTILITY_MPSC_QUEUE_H_
+#define COMMON_UTILITY_MPSC_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <utility>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+// `MpscQueue` is a bounded lock-free FIFO queue with any number of producers
+// and a single consumer. Every cell carries a sequence number telling whether
+// it is free for the producer that claimed its position or filled for the
+// consumer, so producers only contend on the tail counter and the consumer
+// never writes what producers read, apart from releasing cells.
+//
+// Values pushed by one thread are popped in the order they were pushed.
+template <class T, u32 capacity>
+class MpscQueue {
+    static_assert(std::has_single_bit(capacity),
+                  "The capacity must be a power of two");
+
+  public:
+    MpscQueue() {
+      for (u32 i{}; i < capacity; i++) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    void operator=(const MpscQueue&) = delete;
+
+    // Returns false, leaving `value` alone, if the queue is full.
+    bool TryPush(T&& value) {
+      u64 position = tail_.load(std::memory_order_relaxed);
+      while (true) {
+        Cell& cell = cells_[position & kMask];
+        const u64 sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence == position) {
+          if (tail_.compare_exchange_weak(position, position + 1,
+                                          std::memory_order_relaxed)) {
+            cell.value = std::move(value);
+            cell.sequence.store(position + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (sequence < position) {
+          // The consumer has not released the cell from the last lap yet.
+          return false;
+        } else {
+          position = tail_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool TryPush(const T& value) {
+      T copy = value;
+      return TryPush(std::move(copy));
+    }
+
+    // Pops up to `max_count` values and calls `function` with each of them.
+    // Returns how many were popped. Only the consumer may call it.
+    template <class Function>
+    u32 Drain(Function&& function, u32 max_count = capacity) {
+      u32 count = 0;
+      for (; count < max_count; count++) {
+        Cell& cell = cells_[head_ & kMask];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) {
+          break;
+        }
+        function(std::move(cell.value));
+        cell.sequence.store(head_ + capacity, std::memory_order_release);
+        head_++;
+      }
+      return count;
+    }
+
+  private:
+    static constexpr u64 kMask = capacity - 1;
+
+    struct Cell {
+        std::atomic<u64> sequence;
+        T value{};
+    };
+
+    std::array<Cell, capacity> cells_;
+    alignas(64) std::atomic<u64> tail_{0};
+    // Touched by the consumer only.
+    alignas(64) u64 head_{0};
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_MPSC_QUEUE_H_
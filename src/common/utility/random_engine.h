@@ -0,0 +1,37 @@
+#ifndef COMMON_UTILITY_RANDOM_ENGINE_H_
+#define COMMON_UTILITY_RANDOM_ENGINE_H_
+
+#include <concepts>
+#include <random>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+// An engine that `Deck` and other random consumers can be parameterized by:
+// a uniform random bit generator of 64 bit words that can seed itself from the
+// entropy of the operating system.
+template <class Engine>
+concept RandomEngine = std::uniform_random_bit_generator<Engine> &&
+                       std::same_as<typename Engine::result_type, u64> &&
+                       requires {
+                         { Engine::FromEntropy() } -> std::same_as<Engine>;
+                       };
+
+// Returns the engine of the calling thread, seeded from entropy once, on the
+// first call in the thread. Callers must not share it with other threads.
+template <RandomEngine Engine>
+Engine& ThreadLocalEngine() {
+  thread_local Engine engine = Engine::FromEntropy();
+  return engine;
+}
+
+// Reads a 64 bit word out of `std::random_device`.
+inline u64 EntropyWord(std::random_device& device) {
+  const u64 high = device();
+  return (high << 32) | device();
+}
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_RANDOM_ENGINE_H_
@@ -0,0 +1,132 @@
+#ifndef COMMON_UTILITY_SHARDED_LRU_CACHE_H_
+#define COMMON_UTILITY_SHARDED_LRU_CACHE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+// `ShardedLruCache` is a thread safe map of at most `capacity` entries that
+// evicts the least recently used entry when full. Keys are spread over shards
+// by their hash and every shard has its own lock and its own LRU list, so
+// threads working on different keys rarely wait for each other. Eviction is
+// per shard, which keeps the capacity bound exact up to rounding.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ShardedLruCache {
+  public:
+    struct Statistics {
+        u64 hits{};
+        u64 misses{};
+        u64 evictions{};
+        std::size_t size{};
+    };
+
+    explicit ShardedLruCache(std::size_t capacity, u32 shard_count = 16)
+      : shard_capacity_(std::max<std::size_t>(
+          (capacity + shard_count - 1) / shard_count, 1)) {
+      shards_.reserve(shard_count);
+      for (u32 i{}; i < shard_count; i++) {
+        shards_.push_back(std::make_unique<Shard>());
+      }
+    }
+
+    ShardedLruCache(const ShardedLruCache&) = delete;
+    void operator=(const ShardedLruCache&) = delete;
+
+    std::optional<Value> Get(const Key& key) {
+      Shard& shard = GetShard(key);
+      std::lock_guard lock(shard.mutex);
+      const auto it = shard.index.find(key);
+      if (it == shard.index.end()) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      // Most recently used entries are at the front.
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      return it->second->second;
+    }
+
+    void Put(const Key& key, Value value) {
+      Shard& shard = GetShard(key);
+      std::lock_guard lock(shard.mutex);
+      const auto it = shard.index.find(key);
+      if (it != shard.index.end()) {
+        it->second->second = std::move(value);
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+      }
+      if (shard.entries.size() >= shard_capacity_) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+      }
+      shard.entries.emplace_front(key, std::move(value));
+      shard.index.emplace(key, shard.entries.begin());
+    }
+
+    // Returns the cached value, or computes it with `compute()` and caches
+    // it. `compute` runs without any lock held, so two threads missing the
+    // same key at once may both compute it.
+    template <class Compute>
+    Value GetOrCompute(const Key& key, Compute&& compute) {
+      if (std::optional<Value> value = Get(key)) {
+        return *std::move(value);
+      }
+      Value value = compute();
+      Put(key, value);
+      return value;
+    }
+
+    Statistics GetStatistics() const {
+      Statistics statistics{
+        .hits = hits_.load(std::memory_order_relaxed),
+        .misses = misses_.load(std::memory_order_relaxed),
+        .evictions = evictions_.load(std::memory_order_relaxed),
+      };
+      for (const std::unique_ptr<Shard>& shard : shards_) {
+        std::lock_guard lock(shard->mutex);
+        statistics.size += shard->entries.size();
+      }
+      return statistics;
+    }
+
+  private:
+    using Entries = std::list<std::pair<Key, Value>>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        Entries entries;
+        std::unordered_map<Key, typename Entries::iterator, Hash> index;
+    };
+
+    Shard& GetShard(const Key& key) {
+      // The low bits of the hash pick the bucket inside the shard, so the
+      // shard is picked with the high bits of the hash multiplied by a large
+      // odd constant, which also spreads identity hashes of small integers.
+      const u64 hash = static_cast<u64>(Hash{}(key)) * 0x9E3779B97F4A7C15;
+      return *shards_[(hash >> 32) % shards_.size()];
+    }
+
+    const std::size_t shard_capacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<u64> hits_{0};
+    std::atomic<u64> misses_{0};
+    std::atomic<u64> evictions_{0};
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_SHARDED_LRU_CACHE_H_
@@ -0,0 +1,105 @@
+#include "work_stealing_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+WorkStealingPool::WorkStealingPool(u32 thread_count) {
+  if (!thread_count) {
+    thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+  }
+  for (u32 i{}; i <= thread_count; i++) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(thread_count);
+  for (u32 i{}; i < thread_count; i++) {
+    threads_.emplace_back(
+      [this, i](std::stop_token stop_token) { Work(stop_token, i); });
+  }
+}
+
+void WorkStealingPool::ParallelFor(u32 count,
+                                   const std::function<void(u32)>& task) {
+  if (!count) {
+    return;
+  }
+  Batch batch{.task = &task, .remaining = count};
+
+  // Counted before any task is published, as a busy thread may take one and
+  // decrement `pending_` right away.
+  {
+    std::lock_guard lock(wake_mutex_);
+    pending_.fetch_add(count);
+  }
+  for (u32 queue{}; queue < queues_.size(); queue++) {
+    std::lock_guard lock(queues_[queue]->mutex);
+    for (u32 i{queue}; i < count; i += queues_.size()) {
+      queues_[queue]->tasks.push_back({&batch, i});
+    }
+  }
+  wake_.notify_all();
+
+  // Callers share the last queue and help until their batch is taken.
+  const u32 caller_queue = queues_.size() - 1;
+  while (batch.remaining.load()) {
+    const std::optional<Task> next = TakeTask(caller_queue);
+    if (!next) {
+      break;
+    }
+    Run(*next);
+  }
+  // The rest of the batch is running on other threads.
+  std::unique_lock lock(done_mutex_);
+  done_.wait(lock, [&batch]() { return batch.remaining.load() == 0; });
+}
+
+void WorkStealingPool::Work(std::stop_token stop_token, u32 queue) {
+  while (!stop_token.stop_requested()) {
+    if (const std::optional<Task> task = TakeTask(queue)) {
+      Run(*task);
+      continue;
+    }
+    std::unique_lock lock(wake_mutex_);
+    wake_.wait(lock, stop_token, [this]() { return pending_.load() > 0; });
+  }
+}
+
+std::optional<WorkStealingPool::Task> WorkStealingPool::TakeTask(u32 queue) {
+  for (u32 i{}; i < queues_.size(); i++) {
+    Queue& victim = *queues_[(queue + i) % queues_.size()];
+    std::lock_guard lock(victim.mutex);
+    if (victim.tasks.empty()) {
+      continue;
+    }
+    Task task;
+    if (!i) {
+      task = victim.tasks.back();
+      victim.tasks.pop_back();
+    } else {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+    }
+    pending_.fetch_sub(1);
+    return task;
+  }
+  return std::nullopt;
+}
+
+void WorkStealingPool::Run(const Task& task) {
+  (*task.batch->task)(task.index);
+  if (task.batch->remaining.fetch_sub(1) == 1) {
+    // Under the mutex, so a caller about to wait cannot miss the wakeup.
+    std::lock_guard lock(done_mutex_);
+    done_.notify_all();
+  }
+}
+
+} // namespace common::utility
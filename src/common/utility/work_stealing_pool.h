@@ -0,0 +1,84 @@
+#ifndef COMMON_UTILITY_WORK_STEALING_POOL_H_
+#define COMMON_UTILITY_WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "aliasing.h"
+
+namespace common::utility {
+
+// `WorkStealingPool` runs batches of independent tasks on a fixed set of
+// threads. Every thread has its own queue; a batch is dealt round-robin over
+// the queues and a thread that runs out of work steals from the others, so
+// tasks of very different sizes still keep all threads busy. Batches from
+// several callers can be in flight at once.
+class WorkStealingPool {
+  public:
+    // 0 stands for one thread per hardware thread, minus the calling thread
+    // which helps with its own batches.
+    explicit WorkStealingPool(u32 thread_count = 0);
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    void operator=(const WorkStealingPool&) = delete;
+
+    // Calls `task(i)` for every i in [0, count) and returns when all calls
+    // have returned. The calling thread runs tasks while it waits.
+    void ParallelFor(u32 count, const std::function<void(u32)>& task);
+
+    // Threads that run tasks, including a caller of `ParallelFor`.
+    u32 Concurrency() const {
+      return static_cast<u32>(threads_.size()) + 1;
+    }
+
+  private:
+    struct Batch {
+        const std::function<void(u32)>* task;
+        std::atomic<u32> remaining;
+    };
+
+    struct Task {
+        Batch* batch;
+        u32 index;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void Work(std::stop_token stop_token, u32 queue);
+
+    // Takes a task from the back of `queue`, or steals one from the front of
+    // another queue.
+    std::optional<Task> TakeTask(u32 queue);
+
+    void Run(const Task& task);
+
+    // One queue per thread plus one for the callers of `ParallelFor`.
+    std::vector<std::unique_ptr<Queue>> queues_;
+
+    // Number of queued tasks, threads sleep while there are none.
+    std::atomic<u64> pending_{0};
+    std::mutex wake_mutex_;
+    std::condition_variable_any wake_;
+
+    // Signalled when a batch completes. The last task of a batch touches only
+    // these afterwards, as its caller may return and destroy the batch.
+    std::mutex done_mutex_;
+    std::condition_variable done_;
+
+    // Declared last, so the threads stop before the queues are destroyed.
+    std::vector<std::jthread> threads_;
+};
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_WORK_STEALING_POOL_H_
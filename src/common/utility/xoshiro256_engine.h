@@ -0,0 +1,67 @@
+#ifndef COMMON_UTILITY_XOSHIRO256_ENGINE_H_
+#define COMMON_UTILITY_XOSHIRO256_ENGINE_H_
+
+#include <array>
+#include <bit>
+#include <limits>
+#include <random>
+
+#include "aliasing.h"
+#include "utility/random_engine.h"
+
+namespace common::utility {
+
+// `Xoshiro256Engine` is the xoshiro256** generator of Blackman and Vigna: 32
+// bytes of state and a handful of instructions per 64 bit word. It passes the
+// usual statistical test suites but is predictable from its output, so it is
+// meant for simulations, never for dealing real games.
+class Xoshiro256Engine {
+  public:
+    using result_type = u64;
+
+    // The state is expanded from `seed` with splitmix64, as recommended by the
+    // authors, so it is never all zeros.
+    explicit Xoshiro256Engine(u64 seed) {
+      for (u64& word : state_) {
+        seed += 0x9E3779B97F4A7C15;
+        u64 mixed = seed;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+        word = mixed ^ (mixed >> 31);
+      }
+    }
+
+    static Xoshiro256Engine FromEntropy() {
+      std::random_device device;
+      return Xoshiro256Engine{EntropyWord(device)};
+    }
+
+    static constexpr result_type min() {
+      return 0;
+    }
+
+    static constexpr result_type max() {
+      return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+      const u64 result = std::rotl(state_[1] * 5, 7) * 9;
+      const u64 shifted = state_[1] << 17;
+      state_[2] ^= state_[0];
+      state_[3] ^= state_[1];
+      state_[1] ^= state_[2];
+      state_[0] ^= state_[3];
+      state_[2] ^= shifted;
+      state_[3] = std::rotl(state_[3], 45);
+      return result;
+    }
+
+  private:
+    std::array<u64, 4> state_;
+};
+
+static_assert(RandomEngine<Xoshiro256Engine>);
+
+} // namespace common::utility
+
+#endif // !COMMON_UTILITY_XOSHIRO256_ENGINE_H_
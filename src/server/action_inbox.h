@@ -0,0 +1,25 @@
+#ifndef SERVER_ACTION_INBOX_H_
+#define SERVER_ACTION_INBOX_H_
+
+#include "aliasing.h"
+#include "mpsc_queue.h"
+#include "net/wire_protocol.h"
+#include "server_constants.h"
+
+namespace server {
+
+// An action as it reaches the table of the player who sent it.
+struct PlayerAction {
+    u64 player_id{};
+    common::net::ActionMessage action{};
+};
+
+// Every table has one. The network threads of its players push the actions
+// they receive and the table drains them in batches, so neither side waits
+// for the other.
+using ActionInbox =
+  common::utility::MpscQueue<PlayerAction, gActionInboxCapacity>;
+
+} // namespace server
+
+#endif // !SERVER_ACTION_INBOX_H_
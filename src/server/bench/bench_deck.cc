@@ -0,0 +1,118 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <print>
+#include <string_view>
+#include <vector>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/deck.h"
+#include "model/deck_batch.h"
+#include "utility/cpu_features.h"
+
+// Compares dealing with `Deck` and `SimulationDeck` one card at a time against
+// `DeckBatch`, for full shuffles and for 5 card board completions.
+
+namespace {
+
+constexpr u32 kRounds = 1 << 21;
+constexpr u32 kBoardSize = 5;
+constexpr std::size_t kBatchSize = 1024;
+
+// Runs `function`, which deals `kRounds` decks or boards, and prints its rate.
+// Returns the rate in millions per second.
+template <class Function>
+f64 Measure(std::string_view name, Function function) {
+  const auto start = std::chrono::steady_clock::now();
+  const u64 checksum = function();
+  const std::chrono::duration<f64> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  const f64 rate = kRounds / elapsed.count() / 1e6;
+  // The checksum keeps the compiler from dropping the dealt cards.
+  std::print("{:<36} {:8.2f} M/s (checksum {:x})\n", name, rate,
+             checksum & 0xFF);
+  return rate;
+}
+
+template <class DeckType>
+f64 MeasureDeckShuffles(std::string_view name) {
+  return Measure(name, [] {
+    DeckType deck;
+    u64 checksum = 0;
+    for (u32 round{}; round < kRounds; round++) {
+      deck.Reshuffle();
+      while (std::optional<model::Card> card = deck.Deal()) {
+        checksum = checksum * 31 + card->value();
+      }
+    }
+    return checksum;
+  });
+}
+
+template <class DeckType>
+f64 MeasureDeckBoards(std::string_view name, model::CardSet dead) {
+  return Measure(name, [dead] {
+    DeckType deck;
+    u64 checksum = 0;
+    for (u32 round{}; round < kRounds; round++) {
+      deck.Reshuffle(dead);
+      checksum += deck.DealSet(kBoardSize)->bits();
+    }
+    return checksum;
+  });
+}
+
+f64 MeasureBatchShuffles() {
+  return Measure("DeckBatch::Shuffle", [] {
+    model::DeckBatch batch(1);
+    std::vector<model::Card> decks(kBatchSize * model::gDeckSize);
+    u64 checksum = 0;
+    for (u32 round{}; round < kRounds; round += kBatchSize) {
+      batch.Shuffle(decks);
+      checksum = checksum * 31 + decks.back().value();
+    }
+    return checksum;
+  });
+}
+
+f64 MeasureBatchBoards(model::CardSet dead) {
+  return Measure("DeckBatch::DealCompletions", [dead] {
+    model::DeckBatch batch(1);
+    std::vector<model::CardSet> boards(kBatchSize);
+    u64 checksum = 0;
+    for (u32 round{}; round < kRounds; round += kBatchSize) {
+      batch.DealCompletions(kBoardSize, dead, boards);
+      for (model::CardSet board : boards) {
+        checksum += board.bits();
+      }
+    }
+    return checksum;
+  });
+}
+
+} // namespace
+
+int main() {
+  std::print("{} rounds, DeckBatch uses {}\n", kRounds,
+             common::utility::CpuFeatures::HasAvx2() ? "AVX2" : "scalar code");
+
+  std::print("Full shuffles\n");
+  MeasureDeckShuffles<model::Deck>("Deck (ChaCha20)");
+  const f64 deck_shuffles =
+    MeasureDeckShuffles<model::SimulationDeck>("SimulationDeck (xoshiro256**)");
+  const f64 batch_shuffles = MeasureBatchShuffles();
+  std::print("DeckBatch speedup {:.1f}x\n", batch_shuffles / deck_shuffles);
+
+  // Boards of a heads-up all-in, 4 hole cards are dead.
+  const model::CardSet dead{0b1111};
+  std::print("5 card boards\n");
+  MeasureDeckBoards<model::Deck>("Deck (ChaCha20)", dead);
+  const f64 deck_boards = MeasureDeckBoards<model::SimulationDeck>(
+    "SimulationDeck (xoshiro256**)", dead);
+  const f64 batch_boards = MeasureBatchBoards(dead);
+  std::print("DeckBatch speedup {:.1f}x\n", batch_boards / deck_boards);
+  return 0;
+}
@@ -0,0 +1,309 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <print>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/hand_evaluation_state.h"
+#include "model/hand_evaluator.h"
+#include "utility/cpu_features.h"
+
+// Evaluates every 7 card hand through each evaluation path and compares the
+// result of every path for every hand against `HandEvaluator::Evaluate`,
+// which in turn is checked against the known number of hands of every
+// combination. Reports the evaluation rates and their ratio to `Evaluate`.
+// Returns 1 if any path gets a hand wrong.
+//
+// Optionally takes the path of a state table (see generate_hand_state_table)
+// to check and measure the memory mapped backend as well.
+
+namespace {
+
+constexpr u32 kHandSize = 7;
+constexpr u64 kHandCount = 133'784'560;
+constexpr std::size_t kBatchSize = 4096;
+
+using model::CombinationType;
+
+// Number of 7 card hands per combination, indexed by `CombinationType`.
+constexpr std::array<u64, 10> kExpectedCounts = {
+  4'324,      // kRoyalFlush
+  37'260,     // kStraightFlush
+  224'848,    // kFourOfAKind
+  3'473'184,  // kFullHouse
+  4'047'644,  // kFlush
+  6'180'020,  // kStraight
+  6'461'620,  // kThreeOfAKind
+  31'433'400, // kTwoPair
+  58'627'800, // kPair
+  23'294'460, // kHighCard
+};
+
+class Distribution {
+  public:
+    void Add(model::HandStrength strength) {
+      counts_[static_cast<u32>(
+        model::HandEvaluator::GetCombinationType(strength))]++;
+    }
+
+    bool IsExpected() const {
+      return counts_ == kExpectedCounts;
+    }
+
+  private:
+    std::array<u64, 10> counts_{};
+};
+
+// The time spent in one evaluation path and the hands it got wrong.
+class Path {
+  public:
+    explicit Path(std::string_view name) : name_(name) {
+    }
+
+    void Start() {
+      start_ = std::chrono::steady_clock::now();
+    }
+
+    void Stop() {
+      elapsed_ += std::chrono::steady_clock::now() - start_;
+    }
+
+    template <class Function>
+    void Time(Function function) {
+      Start();
+      function();
+      Stop();
+    }
+
+    // Compares the strengths the path computed with those of `Evaluate` for
+    // the same hands.
+    void Check(std::span<const model::HandStrength> strengths,
+               std::span<const model::HandStrength> expected) {
+      for (std::size_t i{}; i < strengths.size(); i++) {
+        mismatches_ += strengths[i] != expected[i];
+      }
+    }
+
+    f64 Seconds() const {
+      return elapsed_.count();
+    }
+
+    // Prints the rate of the path and its ratio to that of `reference`.
+    // Returns whether every hand was right.
+    bool Report(const Path& reference) const {
+      std::print("{:<24} {:8.1f} M hands/s ({:.2f}x)", name_,
+                 kHandCount / Seconds() / 1e6, reference.Seconds() / Seconds());
+      if (mismatches_) {
+        std::print(" - {} WRONG RESULTS", mismatches_);
+      }
+      std::print("\n");
+      return !mismatches_;
+    }
+
+  private:
+    std::string_view name_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::duration<f64> elapsed_{};
+    u64 mismatches_{0};
+};
+
+// Calls `visit` with every 7 card hand.
+template <class Visitor>
+void ForEachHand(Visitor&& visit) {
+  auto enumerate = [&](auto&& self, u32 first, u32 depth, u64 bits) -> void {
+    if (depth == kHandSize) {
+      visit(model::CardSet{bits});
+      return;
+    }
+    for (u32 value{first}; value + kHandSize - depth <= model::gCardNumber;
+         value++) {
+      self(self, value + 1, depth + 1, bits | (u64{1} << value));
+    }
+  };
+  enumerate(enumerate, 0, 0, 0);
+}
+
+// Evaluates the hands through `Evaluate`, `EvaluateBatch` and, if given, the
+// state table, a batch at a time, and checks the other paths against
+// `Evaluate`.
+class BatchChecker {
+  public:
+    BatchChecker(const model::HandEvaluator& evaluator,
+                 const model::HandEvaluator* state_table_evaluator)
+      : evaluator_(evaluator), state_table_evaluator_(state_table_evaluator),
+        expected_(kBatchSize), strengths_(kBatchSize) {
+      hands_.reserve(kBatchSize);
+    }
+
+    void Add(model::CardSet hand) {
+      hands_.push_back(hand);
+      if (hands_.size() == kBatchSize) {
+        Flush();
+      }
+    }
+
+    void Flush() {
+      const std::span<model::HandStrength> expected =
+        std::span(expected_).first(hands_.size());
+      const std::span<model::HandStrength> strengths =
+        std::span(strengths_).first(hands_.size());
+
+      single_.Time([&]() {
+        for (std::size_t i{}; i < hands_.size(); i++) {
+          expected[i] = evaluator_.Evaluate(hands_[i]);
+        }
+      });
+      for (model::HandStrength strength : expected) {
+        distribution_.Add(strength);
+      }
+
+      batch_.Time([&]() { evaluator_.EvaluateBatch(hands_, strengths); });
+      batch_.Check(strengths, expected);
+
+      if (state_table_evaluator_) {
+        state_table_.Time([&]() {
+          for (std::size_t i{}; i < hands_.size(); i++) {
+            strengths[i] = state_table_evaluator_->Evaluate(hands_[i]);
+          }
+        });
+        state_table_.Check(strengths, expected);
+      }
+      hands_.clear();
+    }
+
+    const Path& single() const {
+      return single_;
+    }
+    const Path& batch() const {
+      return batch_;
+    }
+    const Path& state_table() const {
+      return state_table_;
+    }
+    const Distribution& distribution() const {
+      return distribution_;
+    }
+
+  private:
+    const model::HandEvaluator& evaluator_;
+    const model::HandEvaluator* state_table_evaluator_;
+
+    std::vector<model::CardSet> hands_;
+    std::vector<model::HandStrength> expected_;
+    std::vector<model::HandStrength> strengths_;
+
+    Path single_{"Evaluate"};
+    Path batch_{"EvaluateBatch"};
+    Path state_table_{"Evaluate (state table)"};
+    Distribution distribution_;
+};
+
+// Enumerates the hands depth-first, adding and removing one card per step,
+// and checks the strengths against `Evaluate` a batch at a time with the
+// clock stopped.
+class IncrementalChecker {
+  public:
+    explicit IncrementalChecker(const model::HandEvaluator& evaluator)
+      : evaluator_(evaluator) {
+      hands_.reserve(kBatchSize);
+      strengths_.reserve(kBatchSize);
+      expected_.reserve(kBatchSize);
+    }
+
+    void Run() {
+      model::HandEvaluationState state;
+      path_.Start();
+      Enumerate(state, 0, 0, 0);
+      path_.Stop();
+      Check();
+    }
+
+    const Path& path() const {
+      return path_;
+    }
+
+  private:
+    void Enumerate(model::HandEvaluationState& state, u32 first, u32 depth,
+                   u64 bits) {
+      if (depth == kHandSize) {
+        hands_.push_back(model::CardSet{bits});
+        strengths_.push_back(state.Evaluate());
+        if (hands_.size() == kBatchSize) {
+          path_.Stop();
+          Check();
+          path_.Start();
+        }
+        return;
+      }
+      for (u32 value{first}; value + kHandSize - depth <= model::gCardNumber;
+           value++) {
+        const model::CardSet card = model::CardSet::FromValue(value);
+        state.AddCards(card);
+        Enumerate(state, value + 1, depth + 1, bits | (u64{1} << value));
+        state.RemoveCards(card);
+      }
+    }
+
+    void Check() {
+      expected_.clear();
+      for (model::CardSet hand : hands_) {
+        expected_.push_back(evaluator_.Evaluate(hand));
+      }
+      path_.Check(strengths_, expected_);
+      hands_.clear();
+      strengths_.clear();
+    }
+
+    const model::HandEvaluator& evaluator_;
+    std::vector<model::CardSet> hands_;
+    std::vector<model::HandStrength> strengths_;
+    std::vector<model::HandStrength> expected_;
+    Path path_{"HandEvaluationState"};
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  std::print("All {} {} card hands, EvaluateBatch uses {}\n", kHandCount,
+             kHandSize,
+             common::utility::CpuFeatures::HasAvx2() ? "AVX2" : "scalar code");
+
+  const model::HandEvaluator evaluator;
+  std::unique_ptr<const model::HandEvaluator> state_table_evaluator;
+  if (argc > 1) {
+    if (!model::HandEvaluator::UseStateTable(argv[1])) {
+      std::print("Failed to load the state table {}\n", argv[1]);
+      return 1;
+    }
+    // Constructed after `UseStateTable`, so it uses the state table, while
+    // `evaluator` keeps the compact tables.
+    state_table_evaluator = std::make_unique<const model::HandEvaluator>();
+  }
+
+  BatchChecker batch_checker(evaluator, state_table_evaluator.get());
+  ForEachHand([&](model::CardSet hand) { batch_checker.Add(hand); });
+  batch_checker.Flush();
+
+  IncrementalChecker incremental_checker(evaluator);
+  incremental_checker.Run();
+
+  const Path& reference = batch_checker.single();
+  const bool expected_distribution =
+    batch_checker.distribution().IsExpected();
+  std::print("{:<24} {:8.1f} M hands/s{}\n", "Evaluate",
+             kHandCount / reference.Seconds() / 1e6,
+             expected_distribution ? "" : " - WRONG DISTRIBUTION");
+  bool correct = expected_distribution;
+  correct &= batch_checker.batch().Report(reference);
+  correct &= incremental_checker.path().Report(reference);
+  if (state_table_evaluator) {
+    correct &= batch_checker.state_table().Report(reference);
+  }
+  return correct ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#ifndef SERVER_BROADCAST_H_
+#define SERVER_BROADCAST_H_
+
+#include <concepts>
+#include <memory>
+#include <span>
+
+#include "aliasing.h"
+#include "net/shared_message.h"
+#include "net/wire_protocol.h"
+#include "server.h"
+
+namespace server {
+
+// Sends `event` to every recipient, encoded once for all of them. Returns how
+// many recipients are still connected.
+inline u32
+Broadcast(std::span<const std::shared_ptr<Server::Connection>> recipients,
+          const common::net::SharedMessage& event) {
+  u32 reached = 0;
+  for (const std::shared_ptr<Server::Connection>& recipient : recipients) {
+    reached += recipient->Send(event);
+  }
+  return reached;
+}
+
+// Sends `event` to every recipient like the overload above, each followed by
+// `private_message(i)`, the part of the event only the i-th recipient may
+// see, such as their hole cards. Only the private parts are encoded per
+// recipient; binary recipients get the shared bytes and their private frame
+// in one WebSocket message.
+template <class PrivateMessage>
+  requires std::invocable<PrivateMessage&, u32>
+u32 Broadcast(std::span<const std::shared_ptr<Server::Connection>> recipients,
+              const common::net::SharedMessage& event,
+              PrivateMessage&& private_message) {
+  u32 reached = 0;
+  for (u32 i{}; i < recipients.size(); i++) {
+    reached += recipients[i]->Send(event, private_message(i));
+  }
+  return reached;
+}
+
+} // namespace server
+
+#endif // !SERVER_BROADCAST_H_
@@ -0,0 +1,113 @@
+#ifndef SERVER_CONNECTION_REGISTRY_H_
+#define SERVER_CONNECTION_REGISTRY_H_
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "ixwebsocket/IXConnectionState.h"
+
+#include "aliasing.h"
+
+namespace server {
+
+// Parses the id IXWebSocket gives a connection, a decimal number.
+inline std::optional<u64> ParseConnectionId(const ix::ConnectionState& state) {
+  const std::string& id_string = state.getId();
+  u64 id = 0;
+  const auto [end, error] = std::from_chars(
+    id_string.data(), id_string.data() + id_string.size(), id, 10);
+  if (error != std::errc{} || end != id_string.data() + id_string.size()) {
+    return std::nullopt;
+  }
+  return id;
+}
+
+// ConnectionRegistry holds the live connections of the server keyed by their
+// id. Ids are spread over shards, each a hash map with its own lock, so
+// inserting, finding and removing a connection is O(1) and connections opening
+// and closing at the same time rarely wait for each other. `Connection` needs
+// a `u64 id` member.
+template <class Connection>
+class ConnectionRegistry {
+  public:
+    static constexpr u32 kShardCount = 16;
+
+    ConnectionRegistry() = default;
+    ConnectionRegistry(const ConnectionRegistry&) = delete;
+    void operator=(const ConnectionRegistry&) = delete;
+
+    // Returns false, leaving the registry unchanged, if a connection with the
+    // same id is registered already.
+    bool Insert(std::shared_ptr<Connection> connection) {
+      Shard& shard = GetShard(connection->id);
+      std::lock_guard lock{shard.mutex};
+      const u64 id = connection->id;
+      return shard.connections.emplace(id, std::move(connection)).second;
+    }
+
+    // Returns nullptr if there is no connection with the id.
+    std::shared_ptr<Connection> Find(u64 id) const {
+      const Shard& shard = GetShard(id);
+      std::lock_guard lock{shard.mutex};
+      const auto it = shard.connections.find(id);
+      return it == shard.connections.end() ? nullptr : it->second;
+    }
+
+    std::shared_ptr<Connection> Find(const ix::ConnectionState& state) const {
+      const std::optional<u64> id = ParseConnectionId(state);
+      return id ? Find(*id) : nullptr;
+    }
+
+    // Unregisters the connection and returns it, or nullptr if there is no
+    // connection with the id.
+    std::shared_ptr<Connection> Remove(u64 id) {
+      Shard& shard = GetShard(id);
+      std::lock_guard lock{shard.mutex};
+      const auto it = shard.connections.find(id);
+      if (it == shard.connections.end()) {
+        return nullptr;
+      }
+      std::shared_ptr<Connection> connection = std::move(it->second);
+      shard.connections.erase(it);
+      return connection;
+    }
+
+    std::size_t Size() const {
+      std::size_t size = 0;
+      for (const Shard& shard : shards_) {
+        std::lock_guard lock{shard.mutex};
+        size += shard.connections.size();
+      }
+      return size;
+    }
+
+  private:
+    // Aligned to a cache line so that locking one shard does not slow down
+    // its neighbours.
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<u64, std::shared_ptr<Connection>> connections;
+    };
+
+    // IXWebSocket numbers connections consecutively, so the low bits of the
+    // id already spread them evenly.
+    Shard& GetShard(u64 id) {
+      return shards_[id % kShardCount];
+    }
+    const Shard& GetShard(u64 id) const {
+      return shards_[id % kShardCount];
+    }
+
+    std::array<Shard, kShardCount> shards_;
+};
+
+} // namespace server
+
+#endif // !SERVER_CONNECTION_REGISTRY_H_
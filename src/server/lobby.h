@@ -8,11 +8,11 @@
 #include <deque>
 #include <memory>
 #include <mutex>
-#include <print>
 #include <ratio>
 #include <utility>
 
 #include "connection_closure_handler.h"
+#include "logger.h"
 #include "scoped_observation.h"
 #include "server.h"
 #include "stacktrace_analyzer.h"
@@ -50,7 +50,7 @@ class Lobby : public ConnectionClosureHandler::Observer {
       {
         std::lock_guard lock{mutex_};
         data_.push_back(std::move(value));
-        std::print("Pushed. Size: {}\n", data_.size());
+        common::utility::LogDebug("Pushed. Size: {}", data_.size());
       }
       data_cv_.notify_one();
     }
@@ -88,10 +88,12 @@ class Lobby : public ConnectionClosureHandler::Observer {
         }
 
         if (connection->id == id) {
-          std::print("Connection {} erased from lobby\n", id);
+          common::utility::LogDebug("Connection {} erased from lobby", id);
           return true;
         } else {
-          std::print("Connection was closed but the ids differ. Cooked!!!");
+          common::utility::LogError(
+            "Connection was closed but the ids differ. Cooked!!!");
+          common::utility::Logger::Instance().Flush();
           common::utility::StacktraceAnalyzer::PrintOut();
           std::abort();
         }
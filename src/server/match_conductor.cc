@@ -1,63 +1,56 @@
 #include "match_conductor.h"
 
 #include <chrono>
-#include <format>
 #include <memory>
-#include <print>
-#include <string_view>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include "action_inbox.h"
+#include "broadcast.h"
 #include "lobby.h"
+#include "logger.h"
 #include "match_conductor_manager.h"
+#include "net/shared_message.h"
+#include "net/wire_protocol.h"
 #include "server.h"
 
-namespace {
+namespace server {
 
-std::string_view
-FinishReasonToString(server::MatchConductor::FinishReason reason) {
-  switch (reason) {
-  case server::MatchConductor::FinishReason::kNormal:
-    return "The game has finished normally";
-  case server::MatchConductor::FinishReason::kServerFinished:
-    return "The server has forced the game to finish";
-  case server::MatchConductor::FinishReason::kPlayerLeft:
-    return "A player has left";
-  default:
-    return "Undefined reason";
-  }
-}
+using namespace std::literals::chrono_literals;
 
-} // namespace
+namespace {
 
-namespace server {
+// How long the table waits for actions when its inbox is empty.
+constexpr auto kActionPollInterval = 1ms;
 
-using namespace std::literals::chrono_literals;
+constexpr u32 kActionBatchSize = 64;
+
+} // namespace
 
 MatchConductor::MatchConductor(
   std::vector<std::shared_ptr<Server::Connection>> players, Lobby& lobby,
   MatchConductorManager& match_conductor_manager)
-  : players_(std::move(players)), lobby_(lobby) {
+  : players_(std::move(players)), inbox_(std::make_shared<ActionInbox>()),
+    engine_(common::utility::ChaCha20Engine::FromEntropy()), deck_(engine_),
+    lobby_(lobby) {
 
   for (auto& player : players_) {
     if (player->closed.load()) {
-      std::print("Player {} has disconnected\n", player->id);
+      common::utility::LogInfo("Player {} has disconnected", player->id);
     }
+    player->seat.store(inbox_);
   }
 
-  std::print("Starting a game with players: ");
-
+  common::utility::LogInfo("Starting a game with {} players", players_.size());
   for (auto& player : players_) {
-    std::print("{} ", player->id);
+    common::utility::LogInfo("Player {} is in the game", player->id);
   }
-
-  std::print("\n");
 };
 
 // Placeholder logic
 MatchConductor::~MatchConductor() {
-  std::print("MatchConductor Destructor\n");
+  common::utility::LogDebug("MatchConductor Destructor");
 }
 
 // Placeholder logic
@@ -68,16 +61,38 @@ void MatchConductor::ConductGame() {
     }
 
     for (const auto& player : players_) {
-      if (auto ws = player->web_socket.lock()) {
-        ws->send(std::format("Welcome to the game player: {}", player->id));
-      } else {
+      if (!player->Send(common::net::WelcomeMessage{.player_id = player->id})) {
         finish_reason_.store(FinishReason::kPlayerLeft);
         Finish();
         return;
       }
     }
 
-    std::this_thread::sleep_for(5s);
+    deck_.Reshuffle();
+    std::vector<common::net::HoleCardsMessage> hole_cards(players_.size());
+    for (common::net::HoleCardsMessage& cards : hole_cards) {
+      deck_.Deal(cards.cards.size(), cards.cards);
+    }
+    const u32 reached = Broadcast(
+      players_, common::net::SharedMessage(
+                  common::net::TextMessage{.text = "Dealing a new hand"}),
+      [&hole_cards](u32 seat) -> common::net::Message {
+        return hole_cards[seat];
+      });
+    if (reached != players_.size()) {
+      finish_reason_.store(FinishReason::kPlayerLeft);
+      Finish();
+      return;
+    }
+
+    // Until the betting rounds exist the game lasts a fixed time, in which
+    // the actions of the players are only logged.
+    const auto game_end = std::chrono::steady_clock::now() + 5s;
+    while (!stop_ && std::chrono::steady_clock::now() < game_end) {
+      if (!DrainActions()) {
+        std::this_thread::sleep_for(kActionPollInterval);
+      }
+    }
 
     Finish();
   }
@@ -91,13 +106,22 @@ void MatchConductor::ForceFinish() {
   stop_ = true;
 }
 
+u32 MatchConductor::DrainActions() {
+  return inbox_->Drain(
+    [](PlayerAction&& action) {
+      common::utility::LogInfo("Player {} acts: {}", action.player_id,
+                               common::net::EncodeText(action.action));
+    },
+    kActionBatchSize);
+}
+
 void MatchConductor::Finish() {
+  const common::net::SharedMessage finished(
+    common::net::GameFinishedMessage{.reason = finish_reason_.load()});
   for (auto& player : players_) {
+    player->seat.store(nullptr);
     if (!player->closed) {
-      auto ws = player->web_socket.lock();
-      if (ws) {
-        ws->send(FinishReasonToString(finish_reason_.load()).data());
-      }
+      player->Send(finished);
       if (!stop_) {
         lobby_.Push(std::move(player));
       }
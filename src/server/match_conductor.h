@@ -5,7 +5,12 @@
 #include <memory>
 #include <vector>
 
+#include "action_inbox.h"
+#include "aliasing.h"
+#include "model/deck.h"
+#include "net/wire_protocol.h"
 #include "server.h"
+#include "utility/chacha20_engine.h"
 
 namespace server {
 
@@ -23,12 +28,7 @@ class MatchConductorManager;
 // disconnected player will be destroyed.
 class MatchConductor {
   public:
-    enum class FinishReason {
-      kNormal = 0,
-      kServerFinished = 1,
-      kPlayerLeft = 2,
-      kReasonsNum
-    };
+    using FinishReason = common::net::GameFinishReason;
 
     // MatchConductorManaged should move in the vector of Connections into
     // MachConductor's making MatchConductor a second owner of those players.
@@ -49,9 +49,23 @@ class MatchConductor {
     // are not returned to the lobby and destroyed.
     void Finish();
 
+    // Handles up to a batch of the actions players have sent. Returns how
+    // many there were.
+    u32 DrainActions();
+
     // Participants.
     std::vector<std::shared_ptr<Server::Connection>> players_;
 
+    // Actions of the participants, routed here by the server while they are
+    // seated.
+    std::shared_ptr<ActionInbox> inbox_;
+
+    // The conductor is created on the match maker thread and plays on a
+    // thread of its own, so the deck draws from an engine of the conductor
+    // instead of a thread local one.
+    common::utility::ChaCha20Engine engine_;
+    model::Deck deck_;
+
     // Reference to the lobby where players should return after the finished
     // game.
     Lobby& lobby_;
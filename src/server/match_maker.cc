@@ -16,6 +16,7 @@
 #include "connection_closure_handler.h"
 
 #include "lobby.h"
+#include "logger.h"
 #include "server_constants.h"
 #include "server_manager.h"
 #include "stacktrace_analyzer.h"
@@ -58,7 +59,9 @@ size_t MatchMaker::OnConnectionClosed(u64 id) {
       if (connection->id == id) {
         return true;
       } else {
-        std::print("Connection was closed but the ids differ. Cooked!!!");
+        common::utility::LogError(
+          "Connection was closed but the ids differ. Cooked!!!");
+        common::utility::Logger::Instance().Flush();
         common::utility::StacktraceAnalyzer::PrintOut();
         std::abort();
       }
@@ -71,8 +74,8 @@ size_t MatchMaker::OnConnectionClosed(u64 id) {
 
   const size_t result = std::erase_if(intermediate_buffer_, remove_lambda);
   if (result) {
-    std::print(
-      "Connection {} erased from intermediate_buffer_. Buffer size: {}\n", id,
+    common::utility::LogDebug(
+      "Connection {} erased from intermediate_buffer_. Buffer size: {}", id,
       intermediate_buffer_.size());
   }
   return result;
@@ -84,7 +87,7 @@ void MatchMaker::Run() {
       break;
     }
     if (lobby_.Empty()) {
-      std::print("Lobby empty waiting\n");
+      common::utility::LogDebug("Lobby empty waiting");
       std::unique_lock lock{lobby_.mutex_};
       lobby_.data_cv_.wait_for(lock, 1s);
     }
@@ -94,7 +97,7 @@ void MatchMaker::Run() {
       if (lobby_.data_.empty() ||
           intermediate_buffer_.size() == gNumberOfPlayersInGame) {
       } else {
-        std::print("Push back\n");
+        common::utility::LogDebug("Push back");
         intermediate_buffer_.push_back(std::move(lobby_.data_.front()));
         lobby_.data_.pop_front();
       }
@@ -103,7 +106,7 @@ void MatchMaker::Run() {
     {
       std::unique_lock lock{buffer_mutex_};
       if (intermediate_buffer_.size() == gNumberOfPlayersInGame) {
-        std::print("Assemble game\n");
+        common::utility::LogInfo("Assemble game");
         AssembleGame(std::move(lock));
       }
     }
@@ -2,40 +2,100 @@
 
 #include <algorithm>
 #include <array>
-#include <numeric>
+#include <cassert>
 #include <optional>
+#include <random>
+#include <span>
+#include <utility>
 
 #include "aliasing.h"
 #include "model/card.h"
+#include "model/card_set.h"
+#include "utility/chacha20_engine.h"
+#include "utility/random_engine.h"
+#include "utility/xoshiro256_engine.h"
 
 namespace model {
 
-Deck::Deck() {
-  const i32 minimum_rank = static_cast<i32>(Card::Rank::kMinValue);
-  const i32 maximum_rank = static_cast<i32>(Card::Rank::kMaxValue);
-
-  const i32 minimum_suit = static_cast<i32>(Card::Suit::kMinValue);
-  const i32 maximum_suit = static_cast<i32>(Card::Suit::kMaxValue);
+template <common::utility::RandomEngine Engine>
+BasicDeck<Engine>::BasicDeck(Engine& engine) : engine_(&engine) {
+  FillView({});
+}
 
-  for (i32 i = minimum_rank; i <= maximum_rank; i++) {
-    for (i32 j = minimum_suit; j <= maximum_suit; j++) {
-      cards_[j + i * gSuitNumber] =
-          Card(static_cast<Card::Suit>(j), static_cast<Card::Rank>(i));
+template <common::utility::RandomEngine Engine>
+void BasicDeck<Engine>::FillView(CardSet excluded) {
+  size_ = 0;
+  for (u32 value{}; value < gDeckSize; value++) {
+    if (!excluded.ContainsValue(value)) {
+      shuffled_view_[size_++] = Card::FromValue(value);
     }
   }
-
-  Reshuffle();
 }
 
-void Deck::Reshuffle() {
-  std::iota(shuffled_view_.begin(), shuffled_view_.end(), 0);
-  std::shuffle(shuffled_view_.begin(), shuffled_view_.end(), generator_);
+template <common::utility::RandomEngine Engine>
+void BasicDeck<Engine>::Reshuffle(CardSet excluded) {
+  // Dealing only swaps entries, so the view still holds every card when
+  // nothing has been excluded since.
+  if (!excluded.Empty() || size_ != gDeckSize) {
+    FillView(excluded);
+  }
   deal_pointer_ = 0;
+  dealt_ = {};
+}
+
+template <common::utility::RandomEngine Engine>
+Card BasicDeck<Engine>::DrawCard() {
+  assert(deal_pointer_ < size_);
+  std::uniform_int_distribution<u32> distribution(deal_pointer_, size_ - 1);
+  std::swap(shuffled_view_[deal_pointer_],
+            shuffled_view_[distribution(*engine_)]);
+  const Card card = shuffled_view_[deal_pointer_++];
+  dealt_.Insert(card);
+  return card;
 }
 
-std::optional<Card> Deck::Deal() {
-  return deal_pointer_ < gDeckSize ? cards_[shuffled_view_[deal_pointer_++]]
-                                   : std::optional<Card>(std::nullopt);
+template <common::utility::RandomEngine Engine>
+std::optional<Card> BasicDeck<Engine>::Deal() {
+  if (deal_pointer_ >= size_) {
+    return std::nullopt;
+  }
+  return DrawCard();
 }
 
+template <common::utility::RandomEngine Engine>
+bool BasicDeck<Engine>::Deal(u32 count, std::span<Card> out) {
+  assert(out.size() >= count);
+  if (size_ - deal_pointer_ < count) {
+    return false;
+  }
+  for (u32 i{}; i < count; i++) {
+    out[i] = DrawCard();
+  }
+  return true;
+}
+
+template <common::utility::RandomEngine Engine>
+std::optional<CardSet> BasicDeck<Engine>::DealSet(u32 count) {
+  if (size_ - deal_pointer_ < count) {
+    return std::nullopt;
+  }
+  CardSet cards;
+  for (u32 i{}; i < count; i++) {
+    cards.Insert(DrawCard());
+  }
+  return cards;
+}
+
+template <common::utility::RandomEngine Engine>
+bool BasicDeck<Engine>::Burn() {
+  if (deal_pointer_ >= size_) {
+    return false;
+  }
+  DrawCard();
+  return true;
+}
+
+template class BasicDeck<common::utility::ChaCha20Engine>;
+template class BasicDeck<common::utility::Xoshiro256Engine>;
+
 } // namespace model
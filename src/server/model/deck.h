@@ -4,47 +4,100 @@
 #include <array>
 #include <cstddef>
 #include <optional>
-#include <random>
+#include <span>
 
+#include "aliasing.h"
 #include "model/card.h"
+#include "model/card_set.h"
+#include "utility/chacha20_engine.h"
+#include "utility/random_engine.h"
+#include "utility/xoshiro256_engine.h"
 
 namespace model {
 
 constexpr std::size_t gDeckSize = 52;
 
-// `Deck` class models a randomly shuffled collection of `Card` objects.
-class Deck {
+// `BasicDeck` class models a randomly shuffled collection of `Card` objects.
+//
+// The deck is shuffled lazily, one step of the Fisher-Yates shuffle per dealt
+// card: every card is drawn uniformly from the cards not dealt yet. A hand
+// that uses 11 cards costs 11 random numbers instead of a shuffle of all 52.
+//
+// Random numbers come from `Engine`, by default the engine of the thread that
+// creates the deck, so creating a deck does not seed anything. Such a deck
+// must be used by that thread only. Use `Deck` for real games and
+// `SimulationDeck` for simulations.
+template <common::utility::RandomEngine Engine>
+class BasicDeck {
   public:
-    Deck();
+    BasicDeck() : BasicDeck(common::utility::ThreadLocalEngine<Engine>()) {
+    }
+    // Draws from `engine`, which must outlive the deck.
+    explicit BasicDeck(Engine& engine);
 
-    // Shuffles the `card_` array and resets the `deal_pointer_`.
-    // It wouldn't make sense to keep the old value of the `deal_pointer_`.
-    void Reshuffle();
+    // Puts all cards back and resets the `deal_pointer_`. It wouldn't make
+    // sense to keep the old value of the `deal_pointer_`. Cards in `excluded`,
+    // e.g. hole cards that are already known, are left out and will not be
+    // dealt until the next reshuffle. No random numbers are drawn here.
+    void Reshuffle(CardSet excluded = {});
 
     // Returns a card or nullopt if the whole deck has been dealt already.
     std::optional<Card> Deal();
 
+    // Deals `count` cards into the front of `out`, which must be at least as
+    // long. Returns false, without dealing anything, if fewer cards are left.
+    bool Deal(u32 count, std::span<Card> out);
+
+    // Deals `count` cards at once. Returns nullopt, without dealing anything,
+    // if fewer cards are left.
+    std::optional<CardSet> DealSet(u32 count);
+
+    // Deals a card face down, out of play until the next reshuffle. Returns
+    // false if the whole deck has been dealt already.
+    bool Burn();
+
+    // Cards dealt, burned ones included, since the last reshuffle.
+    CardSet Dealt() const {
+      return dealt_;
+    }
+
     bool AnyCardsLeft() {
-      return deal_pointer_ < gDeckSize;
+      return deal_pointer_ < size_;
     }
 
   private:
-    // The cards array. It stores all the cards used for the game.
-    std::array<Card, gDeckSize> cards_;
+    // Moves a random card of the undealt part of `shuffled_view_` to
+    // `deal_pointer_`, advances it and returns the card. Some cards must be
+    // left.
+    Card DrawCard();
 
-    // This is a shuffled view of the `cards_` array. Instead of accessing
-    // `cards_` directly there is a view created that orders cards randomly.
-    // EXPLORE: Is there a way to make `cards_` array implicit?
-    std::array<u32, gDeckSize> shuffled_view_;
+    // Puts all cards but `excluded` in `shuffled_view_`.
+    void FillView(CardSet excluded);
+
+    // The cards of the deck. Only the part before `deal_pointer_` is shuffled,
+    // the rest is in no particular order.
+    std::array<Card, gDeckSize> shuffled_view_;
 
     // The `deal_pointer_` stores an index of a card that will be delt next.
     u32 deal_pointer_{0};
 
-    // Random number generator members.
-    std::random_device random_device_;
-    std::mt19937 generator_{random_device_()};
+    // Number of cards in `shuffled_view_` - excluded cards are not there.
+    u32 size_{gDeckSize};
+
+    CardSet dealt_;
+
+    Engine* engine_;
 };
 
+extern template class BasicDeck<common::utility::ChaCha20Engine>;
+extern template class BasicDeck<common::utility::Xoshiro256Engine>;
+
+// Cryptographically secure, for dealing real games.
+using Deck = BasicDeck<common::utility::ChaCha20Engine>;
+
+// Several times faster but predictable, for Monte Carlo sampling.
+using SimulationDeck = BasicDeck<common::utility::Xoshiro256Engine>;
+
 } // namespace model
 
 #endif // !COMMON_MODEL_DECK_H_
@@ -0,0 +1,207 @@
+#include "deck_batch.h"
+
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/deck.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "aliasing.h"
+#include "utility/cpu_features.h"
+
+namespace model {
+
+namespace {
+
+// A full shuffle draws from 52 cards, then 51 and so on down to 2.
+constexpr std::array<u32, gDeckSize - 1> kShuffleBounds = [] {
+  std::array<u32, gDeckSize - 1> bounds{};
+  for (u32 step{}; step < bounds.size(); step++) {
+    bounds[step] = gDeckSize - step;
+  }
+  return bounds;
+}();
+
+} // namespace
+
+DeckBatch::DeckBatch(u64 seed) {
+  // Lanes are seeded with consecutive outputs of splitmix64.
+  auto next_seed = [&seed]() {
+    seed += 0x9E3779B97F4A7C15;
+    u64 mixed = seed;
+    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9;
+    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EB;
+    return mixed ^ (mixed >> 31);
+  };
+  for (u32 lane{}; lane < kLanes; lane++) {
+    const u64 low = next_seed();
+    const u64 high = next_seed();
+    state_[0][lane] = static_cast<u32>(low);
+    state_[1][lane] = static_cast<u32>(low >> 32);
+    state_[2][lane] = static_cast<u32>(high);
+    state_[3][lane] = static_cast<u32>(high >> 32);
+    // The only state xoshiro never leaves.
+    if (!low && !high) {
+      state_[0][lane] = 1;
+    }
+  }
+  Reset({});
+}
+
+void DeckBatch::Shuffle(std::span<Card> out) {
+  if (!dead_.Empty()) {
+    Reset({});
+  }
+  const std::size_t count = out.size() / gDeckSize;
+  for (std::size_t first{}; first < count; first += kLanes) {
+    Step(kShuffleBounds);
+    const u32 lanes =
+      static_cast<u32>(std::min<std::size_t>(kLanes, count - first));
+    for (u32 lane{}; lane < lanes; lane++) {
+      std::ranges::copy(decks_[lane], out.begin() + (first + lane) * gDeckSize);
+    }
+  }
+}
+
+bool DeckBatch::DealCompletions(u32 count, CardSet dead,
+                                std::span<CardSet> out) {
+  if (dead != dead_) {
+    Reset(dead);
+  }
+  if (size_ < count) {
+    return false;
+  }
+  std::array<u32, gDeckSize> bounds{};
+  for (u32 step{}; step < count; step++) {
+    bounds[step] = size_ - step;
+  }
+
+  for (std::size_t first{}; first < out.size(); first += kLanes) {
+    Step(Bounds(bounds.data(), count));
+    const u32 lanes =
+      static_cast<u32>(std::min<std::size_t>(kLanes, out.size() - first));
+    for (u32 lane{}; lane < lanes; lane++) {
+      u64 bits = 0;
+      for (u32 i{}; i < count; i++) {
+        bits |= u64{1} << decks_[lane][i].value();
+      }
+      out[first + lane] = CardSet{bits};
+    }
+  }
+  return true;
+}
+
+void DeckBatch::Reset(CardSet dead) {
+  std::array<Card, gDeckSize> cards{};
+  size_ = 0;
+  for (u32 value{}; value < gDeckSize; value++) {
+    if (!dead.ContainsValue(value)) {
+      cards[size_++] = Card::FromValue(value);
+    }
+  }
+  decks_.fill(cards);
+  dead_ = dead;
+}
+
+void DeckBatch::Step(Bounds bounds) {
+  Draw(bounds, draws_);
+  // Swaps in different decks are independent, so the lanes are interleaved
+  // to keep several of them in flight.
+  for (u32 step{}; step < bounds.size(); step++) {
+    const u32* draws = draws_.data() + step * kLanes;
+    for (u32 lane{}; lane < kLanes; lane++) {
+      std::swap(decks_[lane][step], decks_[lane][step + draws[lane]]);
+    }
+  }
+}
+
+void DeckBatch::Draw(Bounds bounds, Draws& draws) {
+  static const draw_function implementation =
+    common::utility::CpuFeatures::HasAvx2() ? &DeckBatch::DrawAvx2
+                                            : &DeckBatch::DrawScalar;
+  (this->*implementation)(bounds, draws);
+}
+
+void DeckBatch::DrawScalar(Bounds bounds, Draws& draws) {
+  auto& [s0, s1, s2, s3] = state_;
+  for (u32 step{}; step < bounds.size(); step++) {
+    for (u32 lane{}; lane < kLanes; lane++) {
+      const u32 random = std::rotl(s1[lane] * 5, 7) * 9;
+      const u32 shifted = s1[lane] << 9;
+      s2[lane] ^= s0[lane];
+      s3[lane] ^= s1[lane];
+      s1[lane] ^= s2[lane];
+      s0[lane] ^= s3[lane];
+      s2[lane] ^= shifted;
+      s3[lane] = std::rotl(s3[lane], 11);
+      // Lemire's multiply-shift: the high half of the product is below the
+      // bound.
+      draws[step * kLanes + lane] =
+        static_cast<u32>((u64{random} * bounds[step]) >> 32);
+    }
+  }
+}
+
+#if defined(__x86_64__)
+
+// Same steps as `DrawScalar`, all lanes in one vector. Shifts and additions
+// stand in for the multiplications by 5 and 9.
+__attribute__((target("avx2"))) void DeckBatch::DrawAvx2(Bounds bounds,
+                                                         Draws& draws) {
+  static_assert(kLanes == 8);
+  auto* state = reinterpret_cast<__m256i*>(state_.data());
+  __m256i s0 = _mm256_load_si256(state);
+  __m256i s1 = _mm256_load_si256(state + 1);
+  __m256i s2 = _mm256_load_si256(state + 2);
+  __m256i s3 = _mm256_load_si256(state + 3);
+
+  for (u32 step{}; step < bounds.size(); step++) {
+    __m256i random = _mm256_add_epi32(_mm256_slli_epi32(s1, 2), s1);
+    random = _mm256_or_si256(_mm256_slli_epi32(random, 7),
+                             _mm256_srli_epi32(random, 25));
+    random = _mm256_add_epi32(_mm256_slli_epi32(random, 3), random);
+
+    const __m256i shifted = _mm256_slli_epi32(s1, 9);
+    s2 = _mm256_xor_si256(s2, s0);
+    s3 = _mm256_xor_si256(s3, s1);
+    s1 = _mm256_xor_si256(s1, s2);
+    s0 = _mm256_xor_si256(s0, s3);
+    s2 = _mm256_xor_si256(s2, shifted);
+    s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+
+    // 32 x 32 bit products of the even lanes, then of the odd ones. The high
+    // halves are the draws.
+    const __m256i bound = _mm256_set1_epi32(static_cast<int>(bounds[step]));
+    const __m256i even =
+      _mm256_srli_epi64(_mm256_mul_epu32(random, bound), 32);
+    const __m256i odd =
+      _mm256_mul_epu32(_mm256_srli_epi64(random, 32), bound);
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(draws.data() + step * kLanes),
+      _mm256_blend_epi32(even, odd, 0b10101010));
+  }
+
+  _mm256_store_si256(state, s0);
+  _mm256_store_si256(state + 1, s1);
+  _mm256_store_si256(state + 2, s2);
+  _mm256_store_si256(state + 3, s3);
+}
+
+#else
+
+void DeckBatch::DrawAvx2(Bounds bounds, Draws& draws) {
+  DrawScalar(bounds, draws);
+}
+
+#endif
+
+} // namespace model
@@ -0,0 +1,61 @@
+#include "equity_cache.h"
+
+#include "model/card_set.h"
+#include "model/equity_calculator.h"
+#include "model/suit_canonicalizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "aliasing.h"
+
+namespace model {
+
+std::size_t EquityCache::KeyHash::operator()(const Key& key) const {
+  u64 hash = key.player_count;
+  for (u64 cards : key.cards) {
+    // Mixing step of splitmix64.
+    hash = (hash ^ cards) + 0x9E3779B97F4A7C15;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+    hash ^= hash >> 31;
+  }
+  return static_cast<std::size_t>(hash);
+}
+
+std::optional<EquityResult>
+EquityCache::Enumerate(std::span<const CardSet> hole_cards, CardSet board,
+                       CardSet dead) {
+  // Requests the calculator rejects anyway are not worth a key.
+  if (hole_cards.size() > kMaxPlayers) {
+    return std::nullopt;
+  }
+
+  Key key{.player_count = static_cast<u32>(hole_cards.size())};
+  std::array<CardSet, kMaxPlayers + 2> groups{};
+  std::ranges::copy(hole_cards, groups.begin());
+  groups[hole_cards.size()] = board;
+  groups[hole_cards.size() + 1] = dead;
+  const std::span<const CardSet> used(groups.data(), hole_cards.size() + 2);
+
+  const SuitPermutation permutation =
+    SuitCanonicalizer::CanonicalPermutation(used);
+  for (std::size_t i{}; i < used.size(); i++) {
+    key.cards[i] = permutation.Apply(used[i]).bits();
+  }
+
+  if (std::optional<EquityResult> result = cache_.Get(key)) {
+    return result;
+  }
+  std::optional<EquityResult> result =
+    calculator_.Enumerate(hole_cards, board, dead);
+  if (result) {
+    cache_.Put(key, *result);
+  }
+  return result;
+}
+
+} // namespace model
@@ -0,0 +1,62 @@
+#ifndef SERVER_MODEL_EQUITY_CACHE_H_
+#define SERVER_MODEL_EQUITY_CACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card_set.h"
+#include "model/equity_calculator.h"
+#include "utility/sharded_lru_cache.h"
+
+namespace model {
+
+// `EquityCache` answers repeated exact equity requests, e.g. the all-in
+// display shown to every spectator of a table, from memory. Requests are
+// keyed by their suit canonical form, so requests that differ only by suit
+// names share an entry. Equities do not depend on suit names, so a cached
+// result is returned as is.
+class EquityCache {
+  private:
+    static constexpr u32 kMaxPlayers = 10;
+
+    // Canonical cards of every player, the board and the dead cards.
+    struct Key {
+        std::array<u64, kMaxPlayers + 2> cards{};
+        u32 player_count{};
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    using Cache = common::utility::ShardedLruCache<Key, EquityResult, KeyHash>;
+
+  public:
+    using Statistics = Cache::Statistics;
+
+    // Keeps up to `capacity` results.
+    EquityCache(const EquityCalculator& calculator, std::size_t capacity)
+      : calculator_(calculator), cache_(capacity) {
+    }
+
+    // Same as `EquityCalculator::Enumerate`. Invalid requests are not cached.
+    std::optional<EquityResult> Enumerate(std::span<const CardSet> hole_cards,
+                                          CardSet board, CardSet dead = {});
+
+    Statistics GetStatistics() const {
+      return cache_.GetStatistics();
+    }
+
+  private:
+    const EquityCalculator& calculator_;
+    Cache cache_;
+};
+
+} // namespace model
+
+#endif // !SERVER_MODEL_EQUITY_CACHE_H_
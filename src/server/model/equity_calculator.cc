@@ -0,0 +1,449 @@
+#include "equity_calculator.h"
+
+#include "model/card_set.h"
+#include "model/deck_batch.h"
+#include "model/hand_evaluation_state.h"
+#include "model/hand_evaluator.h"
+#include "model/hand_range.h"
+#include "model/preflop_equity_table.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "aliasing.h"
+#include "utility/random_engine.h"
+#include "utility/work_stealing_pool.h"
+#include "utility/xoshiro256_engine.h"
+
+namespace model {
+
+namespace {
+
+constexpr u32 kMinPlayers = 2;
+constexpr u32 kMaxPlayers = 10;
+constexpr u32 kHoleCardCount = 2;
+constexpr u32 kBoardSize = 5;
+
+// Boards a thread samples between looking at the stopping condition.
+constexpr u32 kChunkSize = 1024;
+// Boards sampled before the standard error is trusted. Requests with no more
+// completions than this are enumerated instead.
+constexpr u64 kMinSampledBoards = 16 * kChunkSize;
+
+struct Totals {
+    u64 boards{};
+    std::array<u64, kMaxPlayers> wins{};
+    std::array<u64, kMaxPlayers> ties{};
+    std::array<f64, kMaxPlayers> shares{};
+    std::array<f64, kMaxPlayers> squared_shares{};
+
+    void Add(const Totals& other) {
+      boards += other.boards;
+      for (u32 i{}; i < kMaxPlayers; i++) {
+        wins[i] += other.wins[i];
+        ties[i] += other.ties[i];
+        shares[i] += other.shares[i];
+        squared_shares[i] += other.squared_shares[i];
+      }
+    }
+
+    // Counts two extra boards, one lost and one won outright, so that a
+    // player who won every board or none so far is not reported exact.
+    f64 StandardError(u32 player) const {
+      const f64 mean = (shares[player] + 1.0) / (boards + 2);
+      const f64 variance = std::max(
+        (squared_shares[player] + 1.0) / (boards + 2) - mean * mean, 0.0);
+      return std::sqrt(variance / boards);
+    }
+};
+
+// Finishes every hand on the complete `board` and adds the outcome.
+void ScoreBoard(const HandEvaluationState& board,
+                std::span<const CardSet> hole_cards, Totals& totals) {
+  std::array<HandStrength, kMaxPlayers> strengths{};
+  HandStrength best = 0;
+  u32 winner_count = 0;
+  for (u32 i{}; i < hole_cards.size(); i++) {
+    HandEvaluationState hand = board;
+    hand.AddCards(hole_cards[i]);
+    strengths[i] = hand.Evaluate();
+    if (strengths[i] > best) {
+      best = strengths[i];
+      winner_count = 1;
+    } else if (strengths[i] == best) {
+      winner_count++;
+    }
+  }
+
+  const f64 share = 1.0 / winner_count;
+  for (u32 i{}; i < hole_cards.size(); i++) {
+    if (strengths[i] != best) {
+      continue;
+    }
+    (winner_count == 1 ? totals.wins : totals.ties)[i]++;
+    totals.shares[i] += share;
+    totals.squared_shares[i] += share * share;
+  }
+  totals.boards++;
+}
+
+// Deals every combination of `missing` cards out of remaining[first...] to
+// `board` and scores the resulting boards.
+void ForEachBoard(HandEvaluationState& board, std::span<const u32> remaining,
+                  u32 first, u32 missing, std::span<const CardSet> hole_cards,
+                  Totals& totals) {
+  if (!missing) {
+    ScoreBoard(board, hole_cards, totals);
+    return;
+  }
+  for (u32 i{first}; i + missing <= remaining.size(); i++) {
+    const CardSet card = CardSet::FromValue(remaining[i]);
+    board.AddCards(card);
+    ForEachBoard(board, remaining, i + 1, missing - 1, hole_cards, totals);
+    board.RemoveCards(card);
+  }
+}
+
+// Number of ways to deal `missing` board cards out of `remaining`.
+u64 CountCompletions(u32 remaining, u32 missing) {
+  u64 count = 1;
+  for (u32 i{}; i < missing; i++) {
+    count = count * (remaining - i) / (i + 1);
+  }
+  return count;
+}
+
+// Returns all cards in play, or nullopt if they are not a valid deal.
+std::optional<CardSet> GetKnownCards(std::span<const CardSet> hole_cards,
+                                     CardSet board, CardSet dead) {
+  if (hole_cards.size() < kMinPlayers || hole_cards.size() > kMaxPlayers ||
+      board.Size() > kBoardSize) {
+    return std::nullopt;
+  }
+  CardSet known = board | dead;
+  u32 known_count = board.Size() + dead.Size();
+  for (CardSet cards : hole_cards) {
+    if (cards.Size() != kHoleCardCount) {
+      return std::nullopt;
+    }
+    known |= cards;
+    known_count += kHoleCardCount;
+  }
+  if (known.Size() != known_count ||
+      gCardNumber - known_count < kBoardSize - board.Size()) {
+    return std::nullopt;
+  }
+  return known;
+}
+
+// Weighted sums of the matchups of two ranges: `first` wins, ties and all
+// matchups, from the point of view of the first range.
+struct RangeTotals {
+    f64 wins{};
+    f64 ties{};
+    f64 matchups{};
+};
+
+// Adds the matchups of the ranges on one complete board. `live` lists the
+// combinations with a weight in either range that do not use the known cards,
+// the ones blocked by the rest of the board are skipped here.
+void ScoreRangeBoard(const HandEvaluationState& board, CardSet runout,
+                     std::span<const u16> live,
+                     std::span<const f32, gComboNumber> first,
+                     std::span<const f32, gComboNumber> second,
+                     RangeTotals& totals) {
+  struct Combo {
+      HandStrength strength;
+      u16 index;
+  };
+  std::array<Combo, gComboNumber> combos;
+  u32 combo_count = 0;
+  for (u16 index : live) {
+    const CardSet cards = HandRange::ComboCards(index);
+    if (cards.Intersects(runout)) {
+      continue;
+    }
+    HandEvaluationState hand = board;
+    hand.AddCards(cards);
+    combos[combo_count++] = {hand.Evaluate(), index};
+  }
+  std::sort(combos.begin(), combos.begin() + combo_count,
+            [](const Combo& a, const Combo& b) {
+              return a.strength < b.strength;
+            });
+
+  // Weights of `second`: all of it, then below the current strength and at
+  // it, each also per card.
+  f64 total = 0.0;
+  std::array<f64, gCardNumber> card_totals{};
+  f64 below = 0.0;
+  std::array<f64, gCardNumber> card_below{};
+  auto add_weight = [](CardSet cards, f64 weight, f64& sum,
+                       std::array<f64, gCardNumber>& card_sums) {
+    sum += weight;
+    for (u64 bits{cards.bits()}; bits; bits &= bits - 1) {
+      card_sums[std::countr_zero(bits)] += weight;
+    }
+  };
+  // Weight of the matchups with combinations that share no card with
+  // `cards`. The combination itself shares both cards and is subtracted
+  // twice, so it is added back once.
+  auto unblocked = [](CardSet cards, f64 sum,
+                      const std::array<f64, gCardNumber>& card_sums,
+                      f64 own_weight) {
+    const u32 low = std::countr_zero(cards.bits());
+    const u32 high = std::bit_width(cards.bits()) - 1;
+    return sum - card_sums[low] - card_sums[high] + own_weight;
+  };
+  for (u32 i{}; i < combo_count; i++) {
+    add_weight(HandRange::ComboCards(combos[i].index),
+               second[combos[i].index], total, card_totals);
+  }
+
+  for (u32 group{}; group < combo_count;) {
+    u32 group_end = group;
+    f64 level = 0.0;
+    std::array<f64, gCardNumber> card_level{};
+    for (; group_end < combo_count &&
+           combos[group_end].strength == combos[group].strength;
+         group_end++) {
+      add_weight(HandRange::ComboCards(combos[group_end].index),
+                 second[combos[group_end].index], level, card_level);
+    }
+
+    for (u32 i{group}; i < group_end; i++) {
+      const u32 index = combos[i].index;
+      if (first[index] == 0.0f) {
+        continue;
+      }
+      const CardSet cards = HandRange::ComboCards(index);
+      // Lower combinations never include the combination itself.
+      totals.wins += first[index] * unblocked(cards, below, card_below, 0.0);
+      totals.ties +=
+        first[index] * unblocked(cards, level, card_level, second[index]);
+      totals.matchups +=
+        first[index] * unblocked(cards, total, card_totals, second[index]);
+    }
+
+    below += level;
+    for (u32 card{}; card < gCardNumber; card++) {
+      card_below[card] += card_level[card];
+    }
+    group = group_end;
+  }
+}
+
+EquityResult MakeResult(const Totals& totals, u32 player_count, bool exact) {
+  EquityResult result;
+  result.boards = totals.boards;
+  result.players.resize(player_count);
+  for (u32 i{}; i < player_count; i++) {
+    PlayerEquity& player = result.players[i];
+    player.win = static_cast<f64>(totals.wins[i]) / totals.boards;
+    player.tie = static_cast<f64>(totals.ties[i]) / totals.boards;
+    player.equity = totals.shares[i] / totals.boards;
+    player.standard_error = exact ? 0.0 : totals.StandardError(i);
+  }
+  return result;
+}
+
+} // namespace
+
+std::optional<EquityResult>
+EquityCalculator::Estimate(std::span<const CardSet> hole_cards, CardSet board,
+                           CardSet dead) const {
+  const std::optional<CardSet> known = GetKnownCards(hole_cards, board, dead);
+  if (!known) {
+    return std::nullopt;
+  }
+  if (std::optional<EquityResult> result =
+        LookupPreflopTable(hole_cards, board, dead)) {
+    return result;
+  }
+  const u32 missing = kBoardSize - board.Size();
+  if (CountCompletions(gCardNumber - known->Size(), missing) <=
+      kMinSampledBoards) {
+    return Enumerate(hole_cards, board, dead);
+  }
+
+  const HandEvaluationState board_state{board};
+  const auto deadline = std::chrono::steady_clock::now() + options_.deadline;
+  std::mutex mutex;
+  std::atomic_bool done{false};
+  Totals totals;
+
+  // One sampler per thread of the pool.
+  pool_.ParallelFor(pool_.Concurrency(), [&](u32) {
+    auto& engine =
+      common::utility::ThreadLocalEngine<common::utility::Xoshiro256Engine>();
+    DeckBatch deck_batch(engine());
+    std::array<CardSet, kChunkSize> completions;
+    Totals local;
+    while (!done.load(std::memory_order_relaxed)) {
+      deck_batch.DealCompletions(missing, *known, completions);
+      for (CardSet completion : completions) {
+        HandEvaluationState complete_board = board_state;
+        complete_board.AddCards(completion);
+        ScoreBoard(complete_board, hole_cards, local);
+      }
+
+      std::lock_guard lock(mutex);
+      totals.Add(local);
+      local = {};
+      f64 standard_error = 0.0;
+      for (u32 i{}; i < hole_cards.size(); i++) {
+        standard_error = std::max(standard_error, totals.StandardError(i));
+      }
+      if ((totals.boards >= kMinSampledBoards &&
+           standard_error <= options_.target_standard_error) ||
+          std::chrono::steady_clock::now() >= deadline) {
+        done.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  return MakeResult(totals, hole_cards.size(), false);
+}
+
+std::optional<EquityResult>
+EquityCalculator::Enumerate(std::span<const CardSet> hole_cards, CardSet board,
+                            CardSet dead) const {
+  const std::optional<CardSet> known = GetKnownCards(hole_cards, board, dead);
+  if (!known) {
+    return std::nullopt;
+  }
+  if (std::optional<EquityResult> result =
+        LookupPreflopTable(hole_cards, board, dead)) {
+    return result;
+  }
+  const u32 missing = kBoardSize - board.Size();
+
+  std::array<u32, gCardNumber> remaining{};
+  u32 remaining_count = 0;
+  for (u32 value{}; value < gCardNumber; value++) {
+    if (!known->ContainsValue(value)) {
+      remaining[remaining_count++] = value;
+    }
+  }
+  const std::span<const u32> remaining_cards{remaining.data(),
+                                             remaining_count};
+
+  // Tasks deal up to two cards, the rest of the board is enumerated within.
+  struct Prefix {
+      CardSet cards;
+      u32 next;
+  };
+  const u32 prefix_size = std::min(missing, 2u);
+  std::vector<Prefix> prefixes;
+  if (prefix_size == 0) {
+    prefixes.push_back({CardSet{}, 0});
+  }
+  for (u32 i{}; prefix_size == 1 && i < remaining_count; i++) {
+    prefixes.push_back({CardSet::FromValue(remaining[i]), i + 1});
+  }
+  for (u32 i{}; prefix_size == 2 && i < remaining_count; i++) {
+    for (u32 j{i + 1}; j + missing - 1 <= remaining_count; j++) {
+      prefixes.push_back(
+        {CardSet::FromValue(remaining[i]) | CardSet::FromValue(remaining[j]),
+         j + 1});
+    }
+  }
+
+  const HandEvaluationState board_state{board};
+  std::mutex mutex;
+  Totals totals;
+  pool_.ParallelFor(prefixes.size(), [&](u32 task) {
+    HandEvaluationState partial_board = board_state;
+    partial_board.AddCards(prefixes[task].cards);
+    Totals local;
+    ForEachBoard(partial_board, remaining_cards, prefixes[task].next,
+                 missing - prefix_size, hole_cards, local);
+
+    std::lock_guard lock(mutex);
+    totals.Add(local);
+  });
+
+  return MakeResult(totals, hole_cards.size(), true);
+}
+
+std::optional<EquityResult>
+EquityCalculator::LookupPreflopTable(std::span<const CardSet> hole_cards,
+                                     CardSet board, CardSet dead) const {
+  if (!options_.preflop_table || !board.Empty() || !dead.Empty()) {
+    return std::nullopt;
+  }
+  return options_.preflop_table->Lookup(hole_cards);
+}
+
+std::optional<EquityResult>
+EquityCalculator::EnumerateRanges(const HandRange& first,
+                                  const HandRange& second, CardSet board,
+                                  CardSet dead) const {
+  if (board.Size() > kBoardSize || board.Intersects(dead)) {
+    return std::nullopt;
+  }
+  const HandRange first_live = first.WithoutCards(board | dead);
+  const HandRange second_live = second.WithoutCards(board | dead);
+  const u32 missing = kBoardSize - board.Size();
+
+  std::vector<CardSet> runouts;
+  auto enumerate = [&](auto&& self, u32 first_value, u32 left,
+                       CardSet runout) -> void {
+    if (!left) {
+      runouts.push_back(runout);
+      return;
+    }
+    for (u32 value{first_value}; value < gCardNumber; value++) {
+      if (!(board | dead).ContainsValue(value)) {
+        self(self, value + 1, left - 1, runout | CardSet::FromValue(value));
+      }
+    }
+  };
+  enumerate(enumerate, 0, missing, CardSet{});
+
+  std::vector<u16> live;
+  for (u32 i{}; i < gComboNumber; i++) {
+    if (first_live.Weight(i) > 0.0f || second_live.Weight(i) > 0.0f) {
+      live.push_back(i);
+    }
+  }
+
+  const HandEvaluationState board_state{board};
+  std::mutex mutex;
+  RangeTotals totals;
+  pool_.ParallelFor(runouts.size(), [&](u32 task) {
+    HandEvaluationState complete_board = board_state;
+    complete_board.AddCards(runouts[task]);
+    RangeTotals local;
+    ScoreRangeBoard(complete_board, runouts[task], live, first_live.weights(),
+                    second_live.weights(), local);
+
+    std::lock_guard lock(mutex);
+    totals.wins += local.wins;
+    totals.ties += local.ties;
+    totals.matchups += local.matchups;
+  });
+  if (totals.matchups <= 0.0) {
+    return std::nullopt;
+  }
+
+  const f64 win = totals.wins / totals.matchups;
+  const f64 tie = totals.ties / totals.matchups;
+  EquityResult result;
+  result.boards = runouts.size();
+  result.players = {
+    {.win = win, .tie = tie, .equity = win + tie / 2},
+    {.win = 1.0 - win - tie, .tie = tie, .equity = 1.0 - win - tie / 2},
+  };
+  return result;
+}
+
+} // namespace model
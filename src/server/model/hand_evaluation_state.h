@@ -0,0 +1,93 @@
+#ifndef SERVER_MODEL_HAND_EVALUATION_STATE_H_
+#define SERVER_MODEL_HAND_EVALUATION_STATE_H_
+
+#include <array>
+#include <bit>
+#include <cassert>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/hand_evaluator.h"
+
+namespace model {
+
+// `HandEvaluationState` is a hand that is built card by card and can be
+// evaluated at any point in O(1). It keeps everything `HandEvaluator` derives
+// from a hand up to date as cards come and go: the cards themselves, the
+// perfect hash key of the ranks and the number of cards of every suit. Adding
+// the turn to a player's flop hand, or pushing and popping cards while
+// enumerating boards depth-first, costs a couple of additions per card instead
+// of rebuilding the hand.
+//
+// Strengths are the same as the ones returned by `HandEvaluator`; the compact
+// tables are always used. Out of line members are defined in
+// hand_evaluator.cc, the only translation unit that generates the tables.
+class HandEvaluationState {
+  public:
+    HandEvaluationState() = default;
+    explicit HandEvaluationState(CardSet cards) {
+      AddCards(cards);
+    }
+
+    // Cards must not be in the hand yet, and the hand must not grow beyond
+    // 7 cards.
+    void AddCards(CardSet cards) {
+      assert(!cards_.Intersects(cards));
+      cards_ |= cards;
+      for (u64 bits{cards.bits()}; bits; bits &= bits - 1) {
+        const u32 value = std::countr_zero(bits);
+        rank_key_ += kCardRankKeys[value];
+        suit_counts_ += SuitCountUnit(value);
+      }
+    }
+
+    // Cards must be in the hand.
+    void RemoveCards(CardSet cards) {
+      assert(cards_.ContainsAll(cards));
+      cards_ -= cards;
+      for (u64 bits{cards.bits()}; bits; bits &= bits - 1) {
+        const u32 value = std::countr_zero(bits);
+        rank_key_ -= kCardRankKeys[value];
+        suit_counts_ -= SuitCountUnit(value);
+      }
+    }
+
+    void AddCard(Card card) {
+      AddCards(CardSet{card});
+    }
+
+    void RemoveCard(Card card) {
+      RemoveCards(CardSet{card});
+    }
+
+    CardSet cards() const {
+      return cards_;
+    }
+
+    // Strength of the best 5 card hand made out of the cards, same as
+    // `HandEvaluator::Evaluate(cards())`.
+    HandStrength Evaluate() const;
+
+  private:
+    // Every suit count is a 4 bit field starting at this bias, so the top bit
+    // of the field is set exactly when the suit has at least 5 cards.
+    static constexpr u32 kSuitCountBias = 0x3333;
+    static constexpr u32 kFlushBits = 0x8888;
+
+    static constexpr u32 SuitCountUnit(u32 value) {
+      return 1u << (value / gRankNumber * 4);
+    }
+
+    // `Card::value()` -> perfect hash key of its rank, see
+    // hand_evaluator_tables.h.
+    static const std::array<u32, gCardNumber> kCardRankKeys;
+
+    CardSet cards_;
+    u32 rank_key_{0};
+    u32 suit_counts_{kSuitCountBias};
+};
+
+} // namespace model
+
+#endif // !SERVER_MODEL_HAND_EVALUATION_STATE_H_
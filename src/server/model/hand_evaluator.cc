@@ -1,218 +1,239 @@
 #include "hand_evaluator.h"
 
 #include "model/card.h"
+#include "model/card_set.h"
+#include "model/hand_evaluation_state.h"
+#include "model/hand_evaluator_tables.h"
+#include "model/hand_state_table.h"
 
-#include <algorithm>
 #include <array>
-#include <cstdlib>
-#include <optional>
-#include <ranges>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <span>
 
-namespace model {
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
-CombinationType HandEvaluator::Evaluate(std::span<const Card> hand) {
-  static constexpr std::array<check_function, 9> checker_functions = {
-      &HandEvaluator::CheckRoyalFlush,   &HandEvaluator::CheckStraightFlush,
-      &HandEvaluator::CheckFourOfAKind,  &HandEvaluator::CheckFullHouse,
-      &HandEvaluator::CheckFlush,        &HandEvaluator::CheckStraight,
-      &HandEvaluator::CheckThreeOfAKind, &HandEvaluator::CheckTwoPair,
-      &HandEvaluator::CheckPair,
-  };
+#include "aliasing.h"
+#include "utility/cpu_features.h"
 
-  for (std::size_t i{}; i < suit_count_mapping_.size(); i++) {
-    suit_count_mapping_[i] = 0;
-  }
+namespace model {
 
-  for (std::size_t i{}; i < rank_count_mapping_.size(); i++) {
-    rank_count_mapping_[i] = 0;
-  }
+using evaluator_tables::kHighHalfShift;
+using evaluator_tables::kLowHalfMask;
+using evaluator_tables::kSuitMask;
+using evaluator_tables::kTables;
 
-  for (const Card& card : hand) {
-    suit_count_mapping_[card.suit()]++;
-    rank_count_mapping_[card.rank()]++;
-  }
+namespace {
 
-  for (check_function function_pointer : checker_functions) {
-    check_return_type result = (this->*function_pointer)(hand);
-    if (result) {
-      return result.value();
-    }
-  }
+// Backend of the process, set once by `UseStateTable` and never released so
+// evaluators can keep a plain pointer.
+std::atomic<const HandStateTable*> gProcessStateTable{nullptr};
 
-  return CombinationType::kHighCard;
+} // namespace
+
+HandEvaluator::HandEvaluator()
+  : state_table_(gProcessStateTable.load(std::memory_order_acquire)) {
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckRoyalFlush(hand_type hand) const {
-  const std::optional<Suit> potential_flush_suit =
-      suit_count_mapping_.return_enum_for([](u8 value) {
-        return value > 4;
-      });
-
-  // Acquiring a royal flush is impossible is none of the suits appears more
-  // than 4 times in the hand.
-  if (!potential_flush_suit) {
-    return {};
+bool HandEvaluator::UseStateTable(const std::filesystem::path& path) {
+  static std::mutex mutex;
+  std::lock_guard lock(mutex);
+  if (gProcessStateTable.load(std::memory_order_relaxed)) {
+    return true;
   }
-
-  auto contains = [&](Rank rank) {
-    return std::find(hand.begin(), hand.end(),
-                     Card{potential_flush_suit.value(), rank}) != hand.end();
-  };
-
-  return contains(Rank::kAce) && contains(Rank::kKing) &&
-                 contains(Rank::kQueen) && contains(Rank::kJack) &&
-                 contains(Rank::kTen)
-             ? CombinationType::kRoyalFlush
-             : check_return_type{};
+  std::unique_ptr<HandStateTable> table = HandStateTable::Open(path);
+  if (!table) {
+    return false;
+  }
+  gProcessStateTable.store(table.release(), std::memory_order_release);
+  return true;
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckStraightFlush(hand_type hand) const {
-  // Find potential flush suit. If one does not exist, return false and
-  // uninitialized card.
-  const std::optional<Suit> potential_flush_suit =
-      suit_count_mapping_.return_enum_for([](u8 value) {
-        return value > 4;
-      });
-
-  // Acquiring a straight flush is impossible is none of the suits appears more
-  // than 4 times in the hand.
-  if (!potential_flush_suit) {
-    return {};
+HandStrength HandEvaluator::Evaluate(CardSet hand) const {
+  // The state table only knows hands of 5 to 7 cards.
+  if (state_table_ && hand.Size() >= 5) {
+    return state_table_->Evaluate(hand);
   }
+  return EvaluateSuitMasks(
+    hand.SuitMask(Suit::kSpades), hand.SuitMask(Suit::kClubs),
+    hand.SuitMask(Suit::kDiamonds), hand.SuitMask(Suit::kHearts));
+}
 
-  // If potential flush exist find the longest consecutive sequence of
-  // Cards.
-  auto filtered = hand | std::ranges::views::filter([&](const Card& card) {
-                    return card.suit() == potential_flush_suit;
-                  });
-
-  auto iterator = filtered.cbegin();
-  Rank previous_rank = iterator->rank();
-  iterator++;
-
-  u8 max_consecutive_counter = 0;
-  // When the consecutive streak is greater or equal than 4 assign new value
-  // to `streak_ending_card`. Counter starts from 0, so by the time it's at
-  // 4, 5 consecutive numbers must have been seen.
-  u8 consecutive_counter = 0;
-  Card streak_ending_card;
-
-  for (; iterator != filtered.end(); iterator++) {
-    if (static_cast<i8>(iterator->rank()) ==
-        static_cast<i8>(previous_rank) + 1) {
-      consecutive_counter++;
-      max_consecutive_counter =
-          std::max(max_consecutive_counter, consecutive_counter);
-    } else {
-      consecutive_counter = 0;
-    }
+HandStrength HandEvaluator::Evaluate(hand_type hand) const {
+  return Evaluate(CardSet{hand});
+}
 
-    if (max_consecutive_counter >= 4) {
-      streak_ending_card = Card{potential_flush_suit.value(), iterator->rank()};
-    }
-    previous_rank = iterator->rank();
+HandStrength HandEvaluator::EvaluateSuitMasks(u32 spades, u32 clubs,
+                                              u32 diamonds, u32 hearts) const {
+  // With at most 7 cards only one suit can have 5 of them, and a hand with a
+  // flush can make neither four of a kind nor a full house, so the flush wins.
+  auto flush_or_zero = [](u32 suit_mask) {
+    return std::popcount(suit_mask) >= 5 ? suit_mask : 0;
+  };
+  const u32 flush_mask = flush_or_zero(spades) | flush_or_zero(clubs) |
+                         flush_or_zero(diamonds) | flush_or_zero(hearts);
+  if (flush_mask) {
+    return kTables.flush_strengths[flush_mask & kSuitMask];
   }
 
-  const bool result = max_consecutive_counter >= 4;
-
-  return CombinationType::kStraightFlush;
-}
-
-HandEvaluator::check_return_type
-HandEvaluator::CheckFourOfAKind([[maybe_unused]] hand_type hand) const {
-  return rank_count_mapping_.return_enum_for([](u8 value) {
-    return value == 4;
-  })
-             ? CombinationType::kFourOfAKind
-             : check_return_type{};
+  const u32 key = kTables.suit_keys[spades & kSuitMask] +
+                  kTables.suit_keys[clubs & kSuitMask] +
+                  kTables.suit_keys[diamonds & kSuitMask] +
+                  kTables.suit_keys[hearts & kSuitMask];
+  return kTables.rank_strengths[kTables.high_offsets[key >> kHighHalfShift] +
+                                kTables.low_offsets[key & kLowHalfMask]];
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckFullHouse(hand_type hand) const {
-  check_return_type pair_result = CheckPair(hand);
-  check_return_type triplet_result = CheckThreeOfAKind(hand);
-
-  return pair_result && triplet_result ? CombinationType::kFullHouse
-                                       : check_return_type{};
+void HandEvaluator::EvaluateBatch(std::span<const CardSet> hands,
+                                  std::span<HandStrength> out) const {
+  assert(out.size() >= hands.size());
+  if (state_table_) {
+    EvaluateBatchScalar(hands, out);
+    return;
+  }
+  static const batch_function implementation =
+    common::utility::CpuFeatures::HasAvx2()
+      ? &HandEvaluator::EvaluateBatchAvx2
+      : &HandEvaluator::EvaluateBatchScalar;
+  (this->*implementation)(hands, out);
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckFlush(hand_type hand) const {
-  return suit_count_mapping_.return_enum_for([](u8 value) {
-    return value == 5;
-  })
-             ? CombinationType::kFlush
-             : check_return_type{};
+void HandEvaluator::EvaluateBatchScalar(std::span<const CardSet> hands,
+                                        std::span<HandStrength> out) const {
+  for (std::size_t i{}; i < hands.size(); i++) {
+    out[i] = Evaluate(hands[i]);
+  }
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckStraight(hand_type hand) const {
-  u8 consecutive_counter = 0;
-  u8 max_consecutive_counter = 0;
-  Rank previous_rank = hand[0].rank();
-
-  for (std::size_t i{1}; i < hand.size(); i++) {
-    if (static_cast<i8>(hand[i].rank()) == static_cast<i8>(previous_rank) + 1) {
-      consecutive_counter++;
-      max_consecutive_counter =
-          std::max(max_consecutive_counter, consecutive_counter);
-    } else {
-      consecutive_counter = 0;
+#if defined(__x86_64__)
+
+// Same steps as `EvaluateSuitMasks`, eight hands at a time, one per 32 bit
+// lane. Table lookups become gathers and the flush branch becomes a blend.
+__attribute__((target("avx2"))) void
+HandEvaluator::EvaluateBatchAvx2(std::span<const CardSet> hands,
+                                 std::span<HandStrength> out) const {
+  static_assert(sizeof(CardSet) == sizeof(u64));
+
+  const auto* suit_keys =
+    reinterpret_cast<const int*>(kTables.suit_keys.data());
+  const auto* flush_strengths =
+    reinterpret_cast<const int*>(kTables.flush_strengths.data());
+  const auto* low_offsets =
+    reinterpret_cast<const int*>(kTables.low_offsets.data());
+  const auto* high_offsets =
+    reinterpret_cast<const int*>(kTables.high_offsets.data());
+  const auto* rank_strengths =
+    reinterpret_cast<const int*>(kTables.rank_strengths.data());
+
+  const __m256i suit_mask = _mm256_set1_epi64x(kSuitMask);
+  const __m256i low_half_mask = _mm256_set1_epi32(kLowHalfMask);
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+  const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+  const __m256i four = _mm256_set1_epi32(4);
+  // Nibble -> number of its set bits.
+  const __m256i nibble_popcount =
+    _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2,
+                     1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  // Suit masks of two vectors of 4 hands end up interleaved, this puts them
+  // back in the order of the hands.
+  const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+  std::size_t i{};
+  for (; i + 8 <= hands.size(); i += 8) {
+    const __m256i first = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(hands.data() + i));
+    const __m256i second = _mm256_loadu_si256(
+      reinterpret_cast<const __m256i*>(hands.data() + i + 4));
+
+    __m256i key = _mm256_setzero_si256();
+    __m256i flush_mask = _mm256_setzero_si256();
+    for (u32 suit{}; suit < gSuitNumber; suit++) {
+      const __m128i shift = _mm_cvtsi32_si128(suit * gRankNumber);
+      const __m256i interleaved = _mm256_or_si256(
+        _mm256_and_si256(_mm256_srl_epi64(first, shift), suit_mask),
+        _mm256_slli_epi64(
+          _mm256_and_si256(_mm256_srl_epi64(second, shift), suit_mask), 32));
+      const __m256i masks =
+        _mm256_permutevar8x32_epi32(interleaved, deinterleave);
+
+      // A suit mask fits in the two lowest bytes of a lane.
+      const __m256i byte_counts = _mm256_add_epi8(
+        _mm256_shuffle_epi8(nibble_popcount,
+                            _mm256_and_si256(masks, nibble_mask)),
+        _mm256_shuffle_epi8(
+          nibble_popcount,
+          _mm256_and_si256(_mm256_srli_epi16(masks, 4), nibble_mask)));
+      const __m256i counts = _mm256_and_si256(
+        _mm256_add_epi32(byte_counts, _mm256_srli_epi32(byte_counts, 8)),
+        byte_mask);
+
+      flush_mask = _mm256_or_si256(
+        flush_mask,
+        _mm256_and_si256(_mm256_cmpgt_epi32(counts, four), masks));
+      key = _mm256_add_epi32(key, _mm256_i32gather_epi32(suit_keys, masks, 4));
     }
 
-    previous_rank = hand[i].rank();
+    const __m256i high = _mm256_i32gather_epi32(
+      high_offsets, _mm256_srli_epi32(key, kHighHalfShift), 4);
+    const __m256i low = _mm256_i32gather_epi32(
+      low_offsets, _mm256_and_si256(key, low_half_mask), 4);
+    __m256i result =
+      _mm256_i32gather_epi32(rank_strengths, _mm256_add_epi32(high, low), 4);
+
+    // `flush_strengths[0]` is 0 and a flush beats anything the ranks alone can
+    // make, so the maximum picks the right strength in every lane.
+    if (!_mm256_testz_si256(flush_mask, flush_mask)) {
+      result = _mm256_max_epu32(
+        result, _mm256_i32gather_epi32(flush_strengths, flush_mask, 4));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.data() + i), result);
   }
 
-  return max_consecutive_counter >= 4 ? CombinationType::kStraight
-                                      : check_return_type{};
+  EvaluateBatchScalar(hands.subspan(i), out.subspan(i));
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckThreeOfAKind([[maybe_unused]] hand_type hand) const {
-  return rank_count_mapping_.return_enum_for([](u8 value) {
-    return value == 3;
-  })
-             ? CombinationType::kFourOfAKind
-             : check_return_type{};
+#else
+
+void HandEvaluator::EvaluateBatchAvx2(std::span<const CardSet> hands,
+                                      std::span<HandStrength> out) const {
+  EvaluateBatchScalar(hands, out);
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckTwoPair([[maybe_unused]] hand_type hand) const {
-  // Check if there is at least one pair.
-  const std::optional<Rank> potential_rank_1 =
-      rank_count_mapping_.return_enum_for([](u8 value) {
-        return value == 2;
-      });
-
-  // Return if there isn't at least one pair.
-  if (!potential_rank_1) {
-    return {};
-  }
+#endif
 
-  // Try to find another pair.
-  const u8 first_pair_rank = static_cast<u8>(potential_rank_1.value());
-  return rank_count_mapping_.return_enum_for([first_pair_rank](u8 value) {
-    // Rank of the fairs pair should be omitted.
-    if (value == first_pair_rank) {
-      return false;
-    }
-    return value == 2;
-  })
-             ? CombinationType::kTwoPair
-             : check_return_type{};
+CombinationType HandEvaluator::GetCombinationType(HandStrength strength) {
+  return static_cast<CombinationType>(
+    static_cast<u32>(CombinationType::kHighCard) -
+    (strength >> evaluator_tables::kCombinationShift));
 }
 
-HandEvaluator::check_return_type
-HandEvaluator::CheckPair([[maybe_unused]] hand_type hand) const {
-
-  return rank_count_mapping_.return_enum_for([](u8 value) {
-    return value == 2;
-  })
-             ? CombinationType::kPair
-             : check_return_type{};
+constinit const std::array<u32, gCardNumber>
+  HandEvaluationState::kCardRankKeys = [] {
+    std::array<u32, gCardNumber> keys{};
+    for (u32 value{}; value < gCardNumber; value++) {
+      keys[value] = evaluator_tables::RankKey(value % gRankNumber);
+    }
+    return keys;
+  }();
+
+HandStrength HandEvaluationState::Evaluate() const {
+  assert(cards_.Size() <= evaluator_tables::kMaxHandSize);
+  // As in `HandEvaluator`, a flush is the best hand whenever there is one.
+  const u32 flush_bits = suit_counts_ & kFlushBits;
+  if (flush_bits) {
+    const auto suit = static_cast<Card::Suit>(std::countr_zero(flush_bits) / 4);
+    return kTables.flush_strengths[cards_.SuitMask(suit)];
+  }
+  return kTables
+    .rank_strengths[kTables.high_offsets[rank_key_ >> kHighHalfShift] +
+                    kTables.low_offsets[rank_key_ & kLowHalfMask]];
 }
 
 } // namespace model
@@ -1,15 +1,17 @@
 #ifndef SERVER_LOGIC_HAND_EVALUATOR_H_
 #define SERVER_LOGIC_HAND_EVALUATOR_H_
 
-#include <optional>
+#include <filesystem>
 #include <span>
 
 #include "aliasing.h"
 #include "model/card.h"
-#include "utility/enum_indexable_array.h"
+#include "model/card_set.h"
 
 namespace model {
 
+class HandStateTable;
+
 enum class CombinationType : i8 {
   kRoyalFlush = 0,
   kStraightFlush = 1,
@@ -23,54 +25,76 @@ enum class CombinationType : i8 {
   kHighCard = 9
 };
 
+// `HandStrength` is a totally ordered score of a hand - the bigger the value,
+// the better the hand, equal values mean a split. Bits 20-23 store the
+// combination (0 for a high card up to 9 for a royal flush). Bits 0-19 store up
+// to five ranks, 4 bits each, most significant first, that break ties within
+// the combination, e.g. the rank of the pair followed by three kickers.
+using HandStrength = u32;
+
+// `HandEvaluator` scores hands of up to 7 cards. Instead of testing for every
+// combination one after another it looks the answer up: a hand is split into
+// four 13 bit suit masks, a flush is resolved by indexing the flush table with
+// the mask of the flush suit, everything else by a perfect hash of the
+// multiset of ranks. The number of memory accesses does not depend on the hand.
+// Tables are generated at compile time, see hand_evaluator_tables.h.
+//
+// Batch analytics can switch the process to a second backend, the memory
+// mapped `HandStateTable`, which trades about 130 MB of page cache for fewer
+// instructions per hand. Results are the same with either backend.
 class HandEvaluator {
   public:
-    using check_return_type = std::optional<CombinationType>;
     using hand_type = std::span<const Card>;
-    using check_function =
-        check_return_type (HandEvaluator::*)(hand_type) const;
-
-    // Evaluates the hand. Returns the highest scoring combination that can be
-    // made out of the hand. If unable to obtain any combination it defaults to
-    // returning "kHighCard".
-    CombinationType Evaluate(std::span<const Card> hand);
 
-  private:
-    using Rank = Card::Rank;
-    using Suit = Card::Suit;
+    // Uses the backend selected for the process when constructed.
+    HandEvaluator();
 
-    // Royal flush contains cards 10 J Q K A of the same suit.
-    check_return_type CheckRoyalFlush(hand_type hand) const;
+    // Selects the state table at `path` (written by the
+    // generate_hand_state_table tool) as the backend of the process.
+    // Evaluators constructed afterwards use it for hands of 5 to 7 cards,
+    // existing ones keep their backend. The table stays mapped until the
+    // process exits, so it is loaded once and later calls only report whether
+    // it is in use. Returns false if the table cannot be loaded.
+    static bool UseStateTable(const std::filesystem::path& path);
 
-    // Straight flush contains consecutive cards of the same suit.
-    check_return_type CheckStraightFlush(hand_type hand) const;
+    // Evaluates the best 5 card hand that can be made out of `hand`. Hands
+    // shorter than 5 cards are scored as well, which is handy for showing
+    // partial hands. The hand must not contain more than 7 cards.
+    HandStrength Evaluate(CardSet hand) const;
 
-    // Four of a kind contains four cards of the same rank.
-    check_return_type CheckFourOfAKind([[maybe_unused]] hand_type hand) const;
+    // Same as above. Duplicated cards are counted once.
+    HandStrength Evaluate(hand_type hand) const;
 
-    // Full house contains a pair and a triplet (three of a kind).
-    check_return_type CheckFullHouse(hand_type hand) const;
+    // Evaluates every hand of `hands` and stores the results under the same
+    // index of `out`, which must be at least as long. Hands are independent,
+    // so on CPUs with AVX2 eight of them are evaluated at once with gathers
+    // from the tables; other CPUs and the state table backend fall back to
+    // calling `Evaluate` in a loop.
+    void EvaluateBatch(std::span<const CardSet> hands,
+                       std::span<HandStrength> out) const;
 
-    // Flush contains 5 cards of the same suit in no particular order.
-    check_return_type CheckFlush(hand_type hand) const;
+    // Extracts the combination from the strength returned by `Evaluate`.
+    static CombinationType GetCombinationType(HandStrength strength);
 
-    // Straight is contains as 5 cards with consecutive ranks.
-    check_return_type CheckStraight(hand_type hand) const;
-
-    // Three of a kind contains three cards of the same rank.
-    check_return_type CheckThreeOfAKind([[maybe_unused]] hand_type hand) const;
+  private:
+    using Suit = Card::Suit;
 
-    // Two pairs contains two pairs of cards of the same rank.
-    check_return_type CheckTwoPair([[maybe_unused]] hand_type hand) const;
+    using batch_function = void (HandEvaluator::*)(std::span<const CardSet>,
+                                                   std::span<HandStrength>)
+      const;
 
-    // Pair contains two cards of the same rank.
-    check_return_type CheckPair([[maybe_unused]] hand_type hand) const;
+    // Implementations of `EvaluateBatch`, one is picked at runtime.
+    void EvaluateBatchScalar(std::span<const CardSet> hands,
+                             std::span<HandStrength> out) const;
+    void EvaluateBatchAvx2(std::span<const CardSet> hands,
+                           std::span<HandStrength> out) const;
 
-    // Mapping: Suit - Number of time it appears in the hand.
-    common::utility::enum_indexable_array<Suit, u8, 4> suit_count_mapping_;
+    // Evaluates a hand given as four 13 bit masks of ranks, one per suit.
+    HandStrength EvaluateSuitMasks(u32 spades, u32 clubs, u32 diamonds,
+                                   u32 hearts) const;
 
-    // Mapping: Rank - Number of time it appears in the hand.
-    common::utility::enum_indexable_array<Rank, u8, 13> rank_count_mapping_;
+    // Null unless the process uses the state table backend.
+    const HandStateTable* state_table_{nullptr};
 };
 
 } // namespace model
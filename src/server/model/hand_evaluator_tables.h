@@ -0,0 +1,288 @@
+#ifndef SERVER_MODEL_HAND_EVALUATOR_TABLES_H_
+#define SERVER_MODEL_HAND_EVALUATOR_TABLES_H_
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <initializer_list>
+
+#include "aliasing.h"
+#include "model/card.h"
+#include "model/hand_evaluator.h"
+
+// Lookup tables of `HandEvaluator`. Everything here is generated by the
+// compiler: `kTables` is a constant expression, so it lands in the read-only
+// data of the executable. There is no work at startup, no data file to ship,
+// and all processes running the executable share the same physical pages.
+//
+// Generating the tables takes more constant evaluation steps than compilers
+// allow by default, see `-fconstexpr-steps` in CMakeLists.txt. Include this
+// header only in the translation units that read the tables.
+namespace model::evaluator_tables {
+
+// Ranks are split into the low half (two to eight) and the high half (nine to
+// ace). Keys of the ranks within each half were found by a greedy search so
+// that the sum of keys of every multiset of at most 7 ranks, with no rank
+// repeated more than 4 times, is unique. Low half sums are stored in bits 0-15,
+// high half sums in bits 16-31 of a key.
+inline constexpr std::array<u32, 7> kHalfRankKeys = {1,   5,    24,  112,
+                                                     521, 2247, 9244};
+inline constexpr u32 kLowHalfRanks = 7;
+inline constexpr u32 kHighHalfShift = 16;
+inline constexpr u32 kLowHalfMask = (1u << kHighHalfShift) - 1;
+
+inline constexpr u32 kSuitMaskCount = 1u << gRankNumber;
+inline constexpr u32 kSuitMask = kSuitMaskCount - 1;
+
+inline constexpr u32 kCombinationShift = 20;
+inline constexpr u32 kMaxHandSize = 7;
+inline constexpr u32 kMaxRankRepetitions = 4;
+
+// Key of a single rank, see `kHalfRankKeys`.
+constexpr u32 RankKey(u32 rank) {
+  return rank < kLowHalfRanks
+           ? kHalfRankKeys[rank]
+           : kHalfRankKeys[rank - kLowHalfRanks] << kHighHalfShift;
+}
+
+// Combination values stored in `HandStrength`, the reverse of
+// `CombinationType`.
+constexpr u32 ToStrengthCombination(CombinationType type) {
+  return static_cast<u32>(CombinationType::kHighCard) - static_cast<u32>(type);
+}
+
+// Packs the combination and ranks (most significant first) into a strength.
+constexpr HandStrength MakeStrength(CombinationType type,
+                                    std::initializer_list<u32> ranks) {
+  HandStrength strength = ToStrengthCombination(type) << kCombinationShift;
+  u32 shift = kCombinationShift;
+  for (u32 rank : ranks) {
+    shift -= 4;
+    strength |= rank << shift;
+  }
+  return strength;
+}
+
+// Returns the rank of the highest card of the best straight in `rank_mask`, or
+// -1 if there is no straight. Ace counts both as the highest and the lowest
+// card.
+constexpr i32 StraightHighRank(u32 rank_mask) {
+  // Bit 0 is a low ace, bit i + 1 is the rank i.
+  const u32 extended = (rank_mask << 1) | (rank_mask >> (gRankNumber - 1));
+  const u32 straights = extended & (extended >> 1) & (extended >> 2) &
+                        (extended >> 3) & (extended >> 4);
+  if (!straights) {
+    return -1;
+  }
+  // Highest straight starts at the highest set bit and ends 4 bits above it,
+  // which is rank 3 above the bit index.
+  return std::bit_width(straights) - 1 + 3;
+}
+
+// Collects up to `N` highest ranks of `rank_mask`.
+template <std::size_t N>
+constexpr std::array<u32, N> HighestRanks(u32 rank_mask) {
+  std::array<u32, N> ranks{};
+  for (std::size_t i{}; i < N && rank_mask; i++) {
+    ranks[i] = std::bit_width(rank_mask) - 1;
+    rank_mask &= ~(1u << ranks[i]);
+  }
+  return ranks;
+}
+
+// Strength of a flush made out of a single suit mask with at least 5 ranks.
+constexpr HandStrength FlushStrength(u32 rank_mask) {
+  const i32 straight_high = StraightHighRank(rank_mask);
+  if (straight_high == static_cast<i32>(Card::Rank::kAce)) {
+    return MakeStrength(CombinationType::kRoyalFlush,
+                        {static_cast<u32>(straight_high)});
+  }
+  if (straight_high >= 0) {
+    return MakeStrength(CombinationType::kStraightFlush,
+                        {static_cast<u32>(straight_high)});
+  }
+  const auto [a, b, c, d, e] = HighestRanks<5>(rank_mask);
+  return MakeStrength(CombinationType::kFlush, {a, b, c, d, e});
+}
+
+// Masks of ranks that appear at least n times, index 0 is unused.
+using RankRepetitions = std::array<u32, kMaxRankRepetitions + 1>;
+
+// Strength of the best hand made out of a multiset of ranks, flushes aside.
+constexpr HandStrength RankStrength(const RankRepetitions& at_least) {
+  if (at_least[4]) {
+    const u32 quads = std::bit_width(at_least[4]) - 1;
+    const auto [kicker] = HighestRanks<1>(at_least[1] & ~(1u << quads));
+    return MakeStrength(CombinationType::kFourOfAKind, {quads, kicker});
+  }
+
+  if (at_least[3]) {
+    const u32 trips = std::bit_width(at_least[3]) - 1;
+    const u32 pairs = at_least[2] & ~(1u << trips);
+    if (pairs) {
+      return MakeStrength(CombinationType::kFullHouse,
+                          {trips, static_cast<u32>(std::bit_width(pairs) - 1)});
+    }
+  }
+
+  const i32 straight_high = StraightHighRank(at_least[1]);
+  if (straight_high >= 0) {
+    return MakeStrength(CombinationType::kStraight,
+                        {static_cast<u32>(straight_high)});
+  }
+
+  if (at_least[3]) {
+    const u32 trips = std::bit_width(at_least[3]) - 1;
+    const auto [a, b] = HighestRanks<2>(at_least[1] & ~(1u << trips));
+    return MakeStrength(CombinationType::kThreeOfAKind, {trips, a, b});
+  }
+
+  if (std::popcount(at_least[2]) >= 2) {
+    const auto [high, low] = HighestRanks<2>(at_least[2]);
+    const auto [kicker] =
+      HighestRanks<1>(at_least[1] & ~(1u << high) & ~(1u << low));
+    return MakeStrength(CombinationType::kTwoPair, {high, low, kicker});
+  }
+
+  if (at_least[2]) {
+    const u32 pair = std::bit_width(at_least[2]) - 1;
+    const auto [a, b, c] = HighestRanks<3>(at_least[1] & ~(1u << pair));
+    return MakeStrength(CombinationType::kPair, {pair, a, b, c});
+  }
+
+  const auto [a, b, c, d, e] = HighestRanks<5>(at_least[1]);
+  return MakeStrength(CombinationType::kHighCard, {a, b, c, d, e});
+}
+
+// Multiset of the ranks of one half.
+struct HalfMultiset {
+    RankRepetitions at_least{};
+    u32 cards{};
+    u32 key{};
+};
+
+// Calls `visit` with every multiset of ranks [first, last) of at most
+// `kMaxHandSize` ranks, none repeated more than `kMaxRankRepetitions` times.
+template <class Visitor>
+constexpr void ForEachHalfMultiset(u32 first, u32 last, Visitor&& visit) {
+  HalfMultiset current{};
+  auto enumerate = [&](auto&& self, u32 rank) -> void {
+    if (rank == last) {
+      visit(current);
+      return;
+    }
+    const HalfMultiset previous = current;
+    for (u32 n{};
+         n <= kMaxRankRepetitions && previous.cards + n <= kMaxHandSize; n++) {
+      if (n) {
+        current.at_least[n] |= 1u << rank;
+      }
+      current.cards = previous.cards + n;
+      current.key = previous.key + n * RankKey(rank);
+      self(self, rank + 1);
+    }
+    current = previous;
+  };
+  enumerate(enumerate, first);
+}
+
+struct HalfStatistics {
+    u32 count{};
+    u32 max_key{};
+    // Number of multisets of at most n ranks.
+    std::array<u32, kMaxHandSize + 1> prefix{};
+};
+
+constexpr HalfStatistics GetHalfStatistics(u32 first, u32 last) {
+  HalfStatistics statistics;
+  ForEachHalfMultiset(first, last, [&](const HalfMultiset& multiset) {
+    statistics.count++;
+    statistics.max_key = std::max(statistics.max_key, multiset.key);
+    for (u32 n{multiset.cards}; n <= kMaxHandSize; n++) {
+      statistics.prefix[n]++;
+    }
+  });
+  return statistics;
+}
+
+inline constexpr HalfStatistics kLowHalf =
+  GetHalfStatistics(0, kLowHalfRanks);
+inline constexpr HalfStatistics kHighHalf =
+  GetHalfStatistics(kLowHalfRanks, gRankNumber);
+
+constexpr u32 CountRankMultisets() {
+  u32 count = 0;
+  ForEachHalfMultiset(kLowHalfRanks, gRankNumber,
+                      [&](const HalfMultiset& high) {
+                        count += kLowHalf.prefix[kMaxHandSize - high.cards];
+                      });
+  return count;
+}
+
+struct Tables {
+    // Suit mask -> sum of the keys of its ranks.
+    std::array<u32, kSuitMaskCount> suit_keys{};
+
+    // Suit mask with at least 5 ranks -> strength of the flush.
+    std::array<HandStrength, kSuitMaskCount> flush_strengths{};
+
+    // Minimal perfect hash of the rank multisets. The strength of a multiset
+    // with the key k is stored under
+    // rank_strengths[high_offsets[k >> 16] + low_offsets[k & 0xFFFF]].
+    // Low half multisets are numbered in the order of their size, so the ones
+    // that can be combined with a given high half multiset form a prefix. Each
+    // high half multiset owns a consecutive range as long as that prefix.
+    std::array<u32, kLowHalf.max_key + 1> low_offsets{};
+    std::array<u32, (kHighHalf.max_key >> kHighHalfShift) + 1> high_offsets{};
+    std::array<HandStrength, CountRankMultisets()> rank_strengths{};
+};
+
+constexpr Tables GenerateTables() {
+  Tables tables;
+
+  for (u32 mask{1}; mask < kSuitMaskCount; mask++) {
+    // The mask without its lowest rank has been filled already.
+    tables.suit_keys[mask] =
+      tables.suit_keys[mask & (mask - 1)] + RankKey(std::countr_zero(mask));
+    if (std::popcount(mask) >= 5) {
+      tables.flush_strengths[mask] = FlushStrength(mask);
+    }
+  }
+
+  // Low half multisets ordered by their size.
+  std::array<HalfMultiset, kLowHalf.count> low_half{};
+  u32 low_count = 0;
+  for (u32 cards{}; cards <= kMaxHandSize; cards++) {
+    ForEachHalfMultiset(0, kLowHalfRanks, [&](const HalfMultiset& low) {
+      if (low.cards == cards) {
+        tables.low_offsets[low.key] = low_count;
+        low_half[low_count++] = low;
+      }
+    });
+  }
+
+  u32 offset = 0;
+  ForEachHalfMultiset(
+    kLowHalfRanks, gRankNumber, [&](const HalfMultiset& high) {
+      tables.high_offsets[high.key >> kHighHalfShift] = offset;
+      for (u32 i{}; i < kLowHalf.prefix[kMaxHandSize - high.cards]; i++) {
+        const RankRepetitions& low = low_half[i].at_least;
+        tables.rank_strengths[offset++] = RankStrength({
+          0,
+          high.at_least[1] | low[1],
+          high.at_least[2] | low[2],
+          high.at_least[3] | low[3],
+          high.at_least[4] | low[4],
+        });
+      }
+    });
+
+  return tables;
+}
+
+inline constexpr Tables kTables = GenerateTables();
+
+} // namespace model::evaluator_tables
+
+#endif // !SERVER_MODEL_HAND_EVALUATOR_TABLES_H_
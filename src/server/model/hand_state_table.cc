@@ -0,0 +1,205 @@
+#include "hand_state_table.h"
+
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/hand_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "aliasing.h"
+#include "utility/mapped_file.h"
+
+namespace model {
+
+namespace {
+
+constexpr u32 kMagic = 0x54534850; // "PHST" read as little endian bytes.
+constexpr u32 kVersion = 1;
+constexpr u32 kHandSize = 7;
+constexpr u32 kFlushSize = 5;
+constexpr u32 kEntriesPerState = gCardNumber + 1;
+// Suit of the cards whose suit does not matter any more.
+constexpr u32 kNoSuit = gSuitNumber;
+constexpr u32 kCodeBits = 7;
+
+struct Header {
+    u32 magic;
+    u32 version;
+    u32 state_count;
+    u32 entry_count;
+};
+
+// Cards of a state, each coded as rank * 5 + suit (or `kNoSuit`), sorted so
+// that the order the cards came in does not matter.
+using StateCards = std::vector<u32>;
+
+u32 CodeRank(u32 code) {
+  return code / (gSuitNumber + 1);
+}
+
+u32 CodeSuit(u32 code) {
+  return code % (gSuitNumber + 1);
+}
+
+u64 MakeKey(const StateCards& cards) {
+  u64 key = cards.size();
+  for (u32 code : cards) {
+    key = (key << kCodeBits) | code;
+  }
+  return key;
+}
+
+// Adds the card `value` to `cards`. Returns nullopt if no valid hand can
+// contain both.
+std::optional<StateCards> AddCard(const StateCards& cards, u32 value) {
+  const u32 rank = value % gRankNumber;
+  const u32 suit = value / gRankNumber;
+
+  StateCards result = cards;
+  std::array<u32, gSuitNumber + 1> suit_counts{};
+  u32 rank_count = 1;
+  for (u32 code : cards) {
+    if (code == rank * (gSuitNumber + 1) + suit) {
+      return std::nullopt;
+    }
+    suit_counts[CodeSuit(code)]++;
+    rank_count += CodeRank(code) == rank;
+  }
+  if (rank_count > gSuitNumber) {
+    return std::nullopt;
+  }
+  result.push_back(rank * (gSuitNumber + 1) + suit);
+  suit_counts[suit]++;
+
+  // Suits that cannot reach 5 cards with the remaining cards are forgotten.
+  // Forgotten suits count as 0 above, which never brings them back.
+  const u32 remaining = kHandSize - result.size();
+  for (u32& code : result) {
+    const u32 code_suit = CodeSuit(code);
+    if (code_suit != kNoSuit &&
+        suit_counts[code_suit] + remaining < kFlushSize) {
+      code = CodeRank(code) * (gSuitNumber + 1) + kNoSuit;
+    }
+  }
+  std::ranges::sort(result);
+  return result;
+}
+
+// Makes a real hand of a terminal state. Cards that forgot their suit get one
+// of the other suits, spread evenly so none of them makes a flush.
+CardSet MakeHand(const StateCards& cards) {
+  CardSet hand;
+  std::array<u32, gSuitNumber> suit_counts{};
+  std::array<bool, gSuitNumber> kept{};
+  for (u32 code : cards) {
+    if (CodeSuit(code) != kNoSuit) {
+      hand |= CardSet::FromValue(CodeSuit(code) * gRankNumber + CodeRank(code));
+      suit_counts[CodeSuit(code)]++;
+      kept[CodeSuit(code)] = true;
+    }
+  }
+  for (u32 code : cards) {
+    if (CodeSuit(code) != kNoSuit) {
+      continue;
+    }
+    std::optional<u32> best_suit;
+    for (u32 suit{}; suit < gSuitNumber; suit++) {
+      if (kept[suit] ||
+          hand.ContainsValue(suit * gRankNumber + CodeRank(code))) {
+        continue;
+      }
+      if (!best_suit || suit_counts[suit] < suit_counts[*best_suit]) {
+        best_suit = suit;
+      }
+    }
+    hand |= CardSet::FromValue(*best_suit * gRankNumber + CodeRank(code));
+    suit_counts[*best_suit]++;
+  }
+  return hand;
+}
+
+} // namespace
+
+std::unique_ptr<HandStateTable>
+HandStateTable::Open(const std::filesystem::path& path) {
+  std::unique_ptr<common::utility::MappedFile> file =
+    common::utility::MappedFile::Open(path);
+  if (!file) {
+    return nullptr;
+  }
+
+  const std::span<const std::byte> data = file->data();
+  if (data.size() < sizeof(Header)) {
+    return nullptr;
+  }
+  const auto* header = reinterpret_cast<const Header*>(data.data());
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->entry_count != header->state_count * kEntriesPerState ||
+      data.size() != sizeof(Header) + header->entry_count * sizeof(u32)) {
+    return nullptr;
+  }
+
+  const std::span<const u32> entries{
+    reinterpret_cast<const u32*>(data.data() + sizeof(Header)),
+    header->entry_count};
+  return std::unique_ptr<HandStateTable>(
+    new HandStateTable(std::move(file), entries));
+}
+
+bool HandStateTable::Generate(const std::filesystem::path& path,
+                              const HandEvaluator& evaluator) {
+  // States are numbered level by level, the empty hand is the state 0.
+  std::vector<StateCards> states{StateCards{}};
+  std::unordered_map<u64, u32> state_ids{{MakeKey(StateCards{}), 0}};
+  std::vector<u32> entries;
+
+  for (u32 id{}; id < states.size(); id++) {
+    // `states` grows below, so the cards are copied.
+    const StateCards cards = states[id];
+    const std::size_t offset = entries.size();
+    entries.resize(offset + kEntriesPerState);
+
+    if (cards.size() >= kFlushSize) {
+      entries[offset] = evaluator.Evaluate(MakeHand(cards));
+    }
+    for (u32 value{}; value < gCardNumber; value++) {
+      const std::optional<StateCards> next = AddCard(cards, value);
+      if (!next) {
+        continue;
+      }
+      if (next->size() == kHandSize) {
+        entries[offset + 1 + value] = evaluator.Evaluate(MakeHand(*next));
+        continue;
+      }
+      const auto [it, inserted] =
+        state_ids.try_emplace(MakeKey(*next), states.size());
+      if (inserted) {
+        states.push_back(*next);
+      }
+      entries[offset + 1 + value] = it->second * kEntriesPerState;
+    }
+  }
+
+  const Header header{
+    .magic = kMagic,
+    .version = kVersion,
+    .state_count = static_cast<u32>(states.size()),
+    .entry_count = static_cast<u32>(entries.size()),
+  };
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()),
+            entries.size() * sizeof(u32));
+  return static_cast<bool>(out);
+}
+
+} // namespace model
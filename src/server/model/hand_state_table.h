@@ -0,0 +1,63 @@
+#ifndef SERVER_MODEL_HAND_STATE_TABLE_H_
+#define SERVER_MODEL_HAND_STATE_TABLE_H_
+
+#include <bit>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "aliasing.h"
+#include "model/card_set.h"
+#include "model/hand_evaluator.h"
+#include "utility/mapped_file.h"
+
+namespace model {
+
+// `HandStateTable` is the precomputed state machine of 5 to 7 card hands
+// ("two plus two" style), memory mapped from a file written once by the
+// generate_hand_state_table tool. Every state is a block of 53 entries: entry
+// 0 is the strength of the hand ending in this state (5 and 6 card states
+// only) and entry 1 + `Card::value()` is the offset of the block the card
+// leads to, or the final strength after the 7th card. Evaluating 7 cards is
+// seven dependent loads.
+//
+// States are canonical: cards of suits that can no longer make a flush forget
+// their suit, so hands differing in such suits share their state. That keeps
+// the table at about 130 MB.
+class HandStateTable {
+  public:
+    // Returns nullptr if the file cannot be mapped or is not a state table.
+    static std::unique_ptr<HandStateTable>
+    Open(const std::filesystem::path& path);
+
+    // Builds the table with `evaluator` and writes it to `path`. Takes a few
+    // seconds and about the size of the table in memory. Returns false on I/O
+    // errors.
+    static bool Generate(const std::filesystem::path& path,
+                         const HandEvaluator& evaluator);
+
+    // Evaluates a hand of 5 to 7 cards, same results as `HandEvaluator`.
+    HandStrength Evaluate(CardSet hand) const {
+      u64 bits = hand.bits();
+      u32 state = 0;
+      for (; bits; bits &= bits - 1) {
+        state = entries_[state + 1 + std::countr_zero(bits)];
+      }
+      // 7 cards end up with the strength itself, fewer with a state.
+      return hand.Size() == 7 ? state : entries_[state];
+    }
+
+  private:
+    explicit HandStateTable(std::unique_ptr<common::utility::MappedFile> file,
+                            std::span<const u32> entries)
+      : file_(std::move(file)), entries_(entries) {
+    }
+
+    std::unique_ptr<common::utility::MappedFile> file_;
+    std::span<const u32> entries_;
+};
+
+} // namespace model
+
+#endif // !SERVER_MODEL_HAND_STATE_TABLE_H_
@@ -0,0 +1,351 @@
+#include "preflop_equity_table.h"
+
+#include "model/card.h"
+#include "model/card_set.h"
+#include "model/equity_calculator.h"
+#include "model/hand_range.h"
+#include "model/suit_canonicalizer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "aliasing.h"
+#include "utility/mapped_file.h"
+
+namespace model {
+
+namespace {
+
+constexpr u32 kMagic = 0x54455050; // "PPET" read as little endian bytes.
+constexpr u32 kVersion = 2;
+constexpr u32 kHoleCardCount = 2;
+constexpr u32 kClassCellCount =
+  PreflopEquityTable::kClassCount * PreflopEquityTable::kClassCount;
+constexpr u32 kHeadsUpPlayers = 2;
+// Completions of an empty board with four and six cards out.
+constexpr u64 kPreflopBoards = 1'712'304;
+constexpr u64 kThreeWayPreflopBoards = 1'370'754;
+
+u32 ComboIndex(CardSet cards) {
+  return HandRange::ComboIndex(std::countr_zero(cards.bits()),
+                               std::bit_width(cards.bits()) - 1);
+}
+
+bool IsMatchup(CardSet first, CardSet second) {
+  return first.Size() == kHoleCardCount && second.Size() == kHoleCardCount &&
+         !first.Intersects(second);
+}
+
+// Rank of a pocket pair, nullopt for any other hole cards.
+std::optional<u32> PairRank(CardSet hole_cards) {
+  if (hole_cards.Size() != kHoleCardCount) {
+    return std::nullopt;
+  }
+  const Card low = Card::FromValue(std::countr_zero(hole_cards.bits()));
+  const Card high = Card::FromValue(std::bit_width(hole_cards.bits()) - 1);
+  if (low.rank() != high.rank()) {
+    return std::nullopt;
+  }
+  return static_cast<u32>(low.rank());
+}
+
+// Key of the canonical form of a three-way matchup, players in the given
+// order.
+u32 ThreeWayKey(std::span<const CardSet> hole_cards) {
+  const SuitPermutation permutation =
+    SuitCanonicalizer::CanonicalPermutation(hole_cards);
+  u32 key = 0;
+  for (CardSet cards : hole_cards) {
+    key = key * gComboNumber + ComboIndex(permutation.Apply(cards));
+  }
+  return key;
+}
+
+} // namespace
+
+struct PreflopEquityTable::Header {
+    u32 magic;
+    u32 version;
+    u32 entry_count;
+    u32 class_count;
+    u32 three_way_count;
+};
+
+std::unique_ptr<PreflopEquityTable>
+PreflopEquityTable::Open(const std::filesystem::path& path) {
+  std::unique_ptr<common::utility::MappedFile> file =
+    common::utility::MappedFile::Open(path);
+  if (!file) {
+    return nullptr;
+  }
+
+  const std::span<const std::byte> data = file->data();
+  if (data.size() < sizeof(Header)) {
+    return nullptr;
+  }
+  const auto* header = reinterpret_cast<const Header*>(data.data());
+  const std::size_t entries_size = header->entry_count * sizeof(Entry);
+  const std::size_t classes_size = kClassCellCount * sizeof(f32);
+  const std::size_t three_way_size =
+    header->three_way_count * sizeof(ThreeWayEntry);
+  if (header->magic != kMagic || header->version != kVersion ||
+      header->class_count != kClassCount ||
+      data.size() !=
+        sizeof(Header) + entries_size + classes_size + three_way_size) {
+    return nullptr;
+  }
+
+  const std::span<const Entry> entries{
+    reinterpret_cast<const Entry*>(data.data() + sizeof(Header)),
+    header->entry_count};
+  const std::span<const f32> class_equities{
+    reinterpret_cast<const f32*>(data.data() + sizeof(Header) + entries_size),
+    kClassCellCount};
+  const std::span<const ThreeWayEntry> three_way_entries{
+    reinterpret_cast<const ThreeWayEntry*>(data.data() + sizeof(Header) +
+                                           entries_size + classes_size),
+    header->three_way_count};
+  return std::unique_ptr<PreflopEquityTable>(new PreflopEquityTable(
+    std::move(file), entries, class_equities, three_way_entries));
+}
+
+bool PreflopEquityTable::Generate(
+  const std::filesystem::path& path, const EquityCalculator& calculator,
+  const std::function<void(u32 done, u32 total)>& progress) {
+  std::vector<CardSet> combos;
+  for (u32 combo{}; combo < gComboNumber; combo++) {
+    combos.push_back(HandRange::ComboCards(combo));
+  }
+
+  std::vector<u32> keys;
+  for (CardSet first : combos) {
+    for (CardSet second : combos) {
+      if (IsMatchup(first, second)) {
+        keys.push_back(MatchupKey(first, second));
+      }
+    }
+  }
+  std::ranges::sort(keys);
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  std::vector<Entry> entries(keys.size());
+  auto find = [&](u32 key) -> Entry& {
+    return entries[std::ranges::lower_bound(keys, key) - keys.begin()];
+  };
+
+  // Three-way matchups of pocket pairs, players from the highest pair down.
+  std::vector<CardSet> pairs;
+  std::ranges::copy_if(combos, std::back_inserter(pairs), [](CardSet combo) {
+    return PairRank(combo).has_value();
+  });
+  std::vector<u32> three_way_keys;
+  for (CardSet first : pairs) {
+    for (CardSet second : pairs) {
+      for (CardSet third : pairs) {
+        if (*PairRank(first) > *PairRank(second) &&
+            *PairRank(second) > *PairRank(third)) {
+          const std::array hole_cards = {first, second, third};
+          three_way_keys.push_back(ThreeWayKey(hole_cards));
+        }
+      }
+    }
+  }
+  std::ranges::sort(three_way_keys);
+  three_way_keys.erase(
+    std::unique(three_way_keys.begin(), three_way_keys.end()),
+    three_way_keys.end());
+
+  // Only one of the two orders of the players is enumerated.
+  std::vector<u32> enumerated;
+  for (std::size_t i{}; i < keys.size(); i++) {
+    entries[i].key = keys[i];
+    const CardSet first = combos[keys[i] / gComboNumber];
+    const CardSet second = combos[keys[i] % gComboNumber];
+    if (MatchupKey(second, first) >= keys[i]) {
+      enumerated.push_back(i);
+    }
+  }
+  const u32 total =
+    static_cast<u32>(enumerated.size() + three_way_keys.size());
+  u32 done = 0;
+  for (u32 index : enumerated) {
+    Entry& entry = entries[index];
+    const std::array hole_cards = {combos[entry.key / gComboNumber],
+                                   combos[entry.key % gComboNumber]};
+    const EquityResult result = *calculator.Enumerate(hole_cards, CardSet{});
+    entry.win = result.players[0].win;
+    entry.tie = result.players[0].tie;
+    if (progress) {
+      progress(++done, total);
+    }
+  }
+
+  std::vector<ThreeWayEntry> three_way_entries(three_way_keys.size());
+  for (std::size_t i{}; i < three_way_keys.size(); i++) {
+    ThreeWayEntry& entry = three_way_entries[i];
+    entry.key = three_way_keys[i];
+    const std::array hole_cards = {
+      combos[entry.key / gComboNumber / gComboNumber],
+      combos[entry.key / gComboNumber % gComboNumber],
+      combos[entry.key % gComboNumber]};
+    const EquityResult result = *calculator.Enumerate(hole_cards, CardSet{});
+    for (u32 player{}; player < kThreeWayPlayers; player++) {
+      entry.win[player] = result.players[player].win;
+      entry.tie[player] = result.players[player].tie;
+      entry.equity[player] = result.players[player].equity;
+    }
+    if (progress) {
+      progress(++done, total);
+    }
+  }
+  for (std::size_t i{}; i < keys.size(); i++) {
+    const CardSet first = combos[keys[i] / gComboNumber];
+    const CardSet second = combos[keys[i] % gComboNumber];
+    const u32 swapped_key = MatchupKey(second, first);
+    if (swapped_key < keys[i]) {
+      const Entry& swapped = find(swapped_key);
+      entries[i].win = 1.0f - swapped.win - swapped.tie;
+      entries[i].tie = swapped.tie;
+    }
+  }
+
+  std::vector<f64> sums(kClassCellCount);
+  std::vector<u32> counts(kClassCellCount);
+  for (CardSet first : combos) {
+    for (CardSet second : combos) {
+      if (!IsMatchup(first, second)) {
+        continue;
+      }
+      const Entry& entry = find(MatchupKey(first, second));
+      const u32 cell = ClassIndex(first) * kClassCount + ClassIndex(second);
+      sums[cell] += entry.win + entry.tie / 2;
+      counts[cell]++;
+    }
+  }
+  std::vector<f32> class_equities(kClassCellCount);
+  for (u32 cell{}; cell < kClassCellCount; cell++) {
+    class_equities[cell] = sums[cell] / counts[cell];
+  }
+
+  const Header header{
+    .magic = kMagic,
+    .version = kVersion,
+    .entry_count = static_cast<u32>(entries.size()),
+    .class_count = kClassCount,
+    .three_way_count = static_cast<u32>(three_way_entries.size()),
+  };
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()),
+            entries.size() * sizeof(Entry));
+  out.write(reinterpret_cast<const char*>(class_equities.data()),
+            class_equities.size() * sizeof(f32));
+  out.write(reinterpret_cast<const char*>(three_way_entries.data()),
+            three_way_entries.size() * sizeof(ThreeWayEntry));
+  return static_cast<bool>(out);
+}
+
+u32 PreflopEquityTable::ClassIndex(CardSet hole_cards) {
+  const u32 low_value = std::countr_zero(hole_cards.bits());
+  const u32 high_value = std::bit_width(hole_cards.bits()) - 1;
+  const u32 low = static_cast<u32>(Card::FromValue(low_value).rank());
+  const u32 high = static_cast<u32>(Card::FromValue(high_value).rank());
+  const u32 top = static_cast<u32>(Card::Rank::kAce);
+  const u32 higher = top - std::max(low, high);
+  const u32 lower = top - std::min(low, high);
+  const bool suited = low_value / gRankNumber == high_value / gRankNumber;
+  return suited ? higher * gRankNumber + lower : lower * gRankNumber + higher;
+}
+
+std::optional<EquityResult> PreflopEquityTable::Lookup(CardSet first,
+                                                       CardSet second) const {
+  if (!IsMatchup(first, second)) {
+    return std::nullopt;
+  }
+  const u32 key = MatchupKey(first, second);
+  const auto entry = std::ranges::lower_bound(entries_, key, {}, &Entry::key);
+  if (entry == entries_.end() || entry->key != key) {
+    return std::nullopt;
+  }
+
+  EquityResult result;
+  result.boards = kPreflopBoards;
+  const f64 loss = 1.0 - entry->win - entry->tie;
+  result.players = {
+    {.win = entry->win,
+     .tie = entry->tie,
+     .equity = entry->win + entry->tie / 2},
+    {.win = loss, .tie = entry->tie, .equity = loss + entry->tie / 2},
+  };
+  return result;
+}
+
+std::optional<EquityResult>
+PreflopEquityTable::Lookup(std::span<const CardSet> hole_cards) const {
+  if (hole_cards.size() == kHeadsUpPlayers) {
+    return Lookup(hole_cards[0], hole_cards[1]);
+  }
+  return LookupThreeWay(hole_cards);
+}
+
+std::optional<EquityResult>
+PreflopEquityTable::LookupThreeWay(std::span<const CardSet> hole_cards) const {
+  if (hole_cards.size() != kThreeWayPlayers) {
+    return std::nullopt;
+  }
+  std::array<u32, kThreeWayPlayers> ranks{};
+  for (u32 player{}; player < kThreeWayPlayers; player++) {
+    const std::optional<u32> rank = PairRank(hole_cards[player]);
+    if (!rank) {
+      return std::nullopt;
+    }
+    ranks[player] = *rank;
+  }
+
+  // Players in the order of the entry, from the highest pair down. Pairs of
+  // different ranks never share a card.
+  std::array<u32, kThreeWayPlayers> order = {0, 1, 2};
+  std::ranges::sort(order, std::ranges::greater{},
+                    [&](u32 player) { return ranks[player]; });
+  if (ranks[order[0]] == ranks[order[1]] ||
+      ranks[order[1]] == ranks[order[2]]) {
+    return std::nullopt;
+  }
+  const std::array sorted = {hole_cards[order[0]], hole_cards[order[1]],
+                             hole_cards[order[2]]};
+  const u32 key = ThreeWayKey(sorted);
+  const auto entry =
+    std::ranges::lower_bound(three_way_entries_, key, {}, &ThreeWayEntry::key);
+  if (entry == three_way_entries_.end() || entry->key != key) {
+    return std::nullopt;
+  }
+
+  EquityResult result;
+  result.boards = kThreeWayPreflopBoards;
+  result.players.resize(kThreeWayPlayers);
+  for (u32 i{}; i < kThreeWayPlayers; i++) {
+    result.players[order[i]] = {.win = entry->win[i],
+                                .tie = entry->tie[i],
+                                .equity = entry->equity[i]};
+  }
+  return result;
+}
+
+u32 PreflopEquityTable::MatchupKey(CardSet first, CardSet second) {
+  const CanonicalHand canonical =
+    SuitCanonicalizer::Canonicalize(first, second);
+  return ComboIndex(canonical.hole_cards) * gComboNumber +
+         ComboIndex(canonical.board);
+}
+
+} // namespace model
@@ -0,0 +1,116 @@
+#ifndef SERVER_MODEL_PREFLOP_EQUITY_TABLE_H_
+#define SERVER_MODEL_PREFLOP_EQUITY_TABLE_H_
+
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card_set.h"
+#include "model/equity_calculator.h"
+#include "utility/mapped_file.h"
+#include "utility/work_stealing_pool.h"
+
+namespace model {
+
+// `PreflopEquityTable` holds the exact heads-up preflop equity of every
+// matchup of two hands, memory mapped from a file written once by the
+// generate_preflop_equity_table tool. Matchups that differ only by suit names
+// share an entry, which leaves 93769 of them (about 1.1 MB), sorted by key so
+// a lookup is a canonicalization and a binary search.
+//
+// The table also averages the matchups of the 169 starting hand classes, e.g.
+// "AKs" against "QQ", laid out in the usual 13x13 grid: pairs on the
+// diagonal, suited hands above it and offsuit hands below it.
+//
+// Of the multi-way spots it covers one common pattern exactly: three pocket
+// pairs of different ranks. Players are sorted by rank and suits renamed, which
+// leaves 12 suit patterns for each of the 286 rank triples.
+class PreflopEquityTable {
+  public:
+    static constexpr u32 kClassCount = 169;
+
+    // Returns nullptr if the file cannot be mapped or is not a preflop table.
+    static std::unique_ptr<PreflopEquityTable>
+    Open(const std::filesystem::path& path);
+
+    // Enumerates every matchup with `calculator`, which must not use a
+    // preflop table itself, and writes the table to `path`. Takes about an
+    // hour of CPU time - 47 thousand matchups of 1.7 million boards, the rest
+    // follows by symmetry - and the three-way pairs a few more minutes.
+    // `progress`, if set, is called after each enumerated matchup with the
+    // number done so far and the total. Returns false on I/O errors.
+    static bool
+    Generate(const std::filesystem::path& path,
+             const EquityCalculator& calculator,
+             const std::function<void(u32 done, u32 total)>& progress = {});
+
+    // Class of two hole cards in the 13x13 grid: the row is the higher rank
+    // of suited hands and pairs, the column the higher rank of offsuit ones,
+    // both counted from the ace.
+    static u32 ClassIndex(CardSet hole_cards);
+
+    // Equity of two players with `first` and `second` hole cards, nullopt if
+    // they are not two disjoint pairs of cards.
+    std::optional<EquityResult> Lookup(CardSet first, CardSet second) const;
+
+    // Equity of the players with `hole_cards`: two players as above, or three
+    // with pocket pairs of different ranks. Returns nullopt for any other
+    // hands.
+    std::optional<EquityResult>
+    Lookup(std::span<const CardSet> hole_cards) const;
+
+    // Equity of the class `first` against the class `second`, every matchup
+    // of two disjoint combinations weighted equally.
+    f32 ClassEquity(u32 first, u32 second) const {
+      return class_equities_[first * kClassCount + second];
+    }
+
+  private:
+    struct Header;
+
+    static constexpr u32 kThreeWayPlayers = 3;
+
+    // A canonical matchup and the result of its first player.
+    struct Entry {
+        u32 key;
+        f32 win;
+        f32 tie;
+    };
+
+    // A canonical three-way matchup of pocket pairs and the results of its
+    // players, highest pair first.
+    struct ThreeWayEntry {
+        u32 key;
+        std::array<f32, kThreeWayPlayers> win;
+        std::array<f32, kThreeWayPlayers> tie;
+        std::array<f32, kThreeWayPlayers> equity;
+    };
+
+    PreflopEquityTable(std::unique_ptr<common::utility::MappedFile> file,
+                       std::span<const Entry> entries,
+                       std::span<const f32> class_equities,
+                       std::span<const ThreeWayEntry> three_way_entries)
+      : file_(std::move(file)), entries_(entries),
+        class_equities_(class_equities),
+        three_way_entries_(three_way_entries) {
+    }
+
+    // Key of the canonical form of a matchup.
+    static u32 MatchupKey(CardSet first, CardSet second);
+
+    std::optional<EquityResult>
+    LookupThreeWay(std::span<const CardSet> hole_cards) const;
+
+    std::unique_ptr<common::utility::MappedFile> file_;
+    std::span<const Entry> entries_;
+    std::span<const f32> class_equities_;
+    std::span<const ThreeWayEntry> three_way_entries_;
+};
+
+} // namespace model
+
+#endif // !SERVER_MODEL_PREFLOP_EQUITY_TABLE_H_
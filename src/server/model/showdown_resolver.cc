@@ -0,0 +1,114 @@
+#include "showdown_resolver.h"
+
+#include "model/card_set.h"
+#include "model/hand_evaluation_state.h"
+#include "model/hand_evaluator.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <span>
+
+#include "aliasing.h"
+
+namespace model {
+
+namespace {
+
+constexpr u32 kHoleCardCount = 2;
+
+} // namespace
+
+ShowdownResult
+ShowdownResolver::Resolve(CardSet board,
+                          std::span<const ShowdownPlayer> players, u32 button) {
+  assert(players.size() <= ShowdownResult::kMaxPlayers);
+  assert(button < players.size());
+
+  ShowdownResult result;
+  const HandEvaluationState board_state{board};
+
+  // Distinct contributions of the players still in the hand, ascending.
+  std::array<Chips, ShowdownResult::kMaxPlayers> levels{};
+  u32 level_count = 0;
+  for (u32 i{}; i < players.size(); i++) {
+    const ShowdownPlayer& player = players[i];
+    if (player.folded) {
+      continue;
+    }
+    assert(player.hole_cards.Size() == kHoleCardCount);
+    assert(!player.hole_cards.Intersects(board));
+
+    HandEvaluationState state = board_state;
+    state.AddCards(player.hole_cards);
+    result.strengths[i] = state.Evaluate();
+
+    // Insertion sort of the distinct levels, there are few of them.
+    const auto levels_end = levels.begin() + level_count;
+    if (std::find(levels.begin(), levels_end, player.contribution) !=
+        levels_end) {
+      continue;
+    }
+    u32 position = level_count++;
+    for (; position && levels[position - 1] > player.contribution; position--) {
+      levels[position] = levels[position - 1];
+    }
+    levels[position] = player.contribution;
+  }
+  assert(level_count > 0);
+
+  Chips previous_level = 0;
+  for (u32 level{}; level < level_count; level++) {
+    ShowdownResult::Pot pot;
+    const bool top_level = level + 1 == level_count;
+    for (u32 i{}; i < players.size(); i++) {
+      const Chips contribution = players[i].contribution;
+      // Chips of folded players above the top level are still in the pot.
+      const Chips upper =
+        top_level ? contribution : std::min(contribution, levels[level]);
+      pot.amount += upper - std::min(upper, previous_level);
+      if (!players[i].folded && contribution >= levels[level]) {
+        pot.eligible |= 1u << i;
+      }
+    }
+    previous_level = levels[level];
+    if (!pot.amount) {
+      continue;
+    }
+
+    HandStrength best = 0;
+    for (u16 eligible{pot.eligible}; eligible; eligible &= eligible - 1) {
+      const u32 i = std::countr_zero(eligible);
+      if (!pot.winners || result.strengths[i] > best) {
+        best = result.strengths[i];
+        pot.winners = 0;
+      }
+      if (result.strengths[i] == best) {
+        pot.winners |= 1u << i;
+      }
+    }
+
+    const u32 winner_count = std::popcount(pot.winners);
+    const Chips share = pot.amount / winner_count;
+    Chips odd_chips = pot.amount % winner_count;
+    // Seats to the left of the button first.
+    for (u32 step{1}; step <= players.size(); step++) {
+      const u32 i = (button + step) % players.size();
+      if (!(pot.winners & (1u << i))) {
+        continue;
+      }
+      result.winnings[i] += share;
+      if (odd_chips) {
+        result.winnings[i]++;
+        odd_chips--;
+      }
+    }
+
+    result.pots[result.pot_count++] = pot;
+  }
+
+  return result;
+}
+
+} // namespace model
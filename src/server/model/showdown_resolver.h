@@ -0,0 +1,69 @@
+#ifndef SERVER_MODEL_SHOWDOWN_RESOLVER_H_
+#define SERVER_MODEL_SHOWDOWN_RESOLVER_H_
+
+#include <array>
+#include <span>
+
+#include "aliasing.h"
+#include "model/card_set.h"
+#include "model/hand_evaluator.h"
+
+namespace model {
+
+using Chips = u64;
+
+// Seat taking part in the showdown.
+struct ShowdownPlayer {
+    CardSet hole_cards;
+    // Chips the player has put into the pot over the whole hand.
+    Chips contribution{};
+    // Folded players cannot win, their chips stay in the pot.
+    bool folded{false};
+};
+
+// `ShowdownResult` describes the pots built from the contributions, the main
+// pot first. Players are referred to by their index in the input, sets of
+// players are bitmasks.
+struct ShowdownResult {
+    static constexpr u32 kMaxPlayers = 10;
+
+    struct Pot {
+        Chips amount{};
+        // Players that can win the pot.
+        u16 eligible{};
+        // Players with the best hand among `eligible`, sharing the pot.
+        u16 winners{};
+    };
+
+    std::array<Pot, kMaxPlayers> pots{};
+    u32 pot_count{};
+
+    // Strengths of the hands of players that did not fold, 0 otherwise.
+    std::array<HandStrength, kMaxPlayers> strengths{};
+
+    // Chips won by every player over all pots.
+    std::array<Chips, kMaxPlayers> winnings{};
+};
+
+// `ShowdownResolver` decides who wins what at the end of a hand. Pots are
+// layered by the distinct contributions of the players still in the hand, so
+// an all-in player only competes for the chips they could match. A pot split
+// between several winners is divided evenly and the chips that do not divide
+// go one by one to the winners closest to the left of the button.
+//
+// The board is evaluated once and every hand is finished from that state with
+// its two hole cards. Nothing is allocated and the only sort is over at most
+// 10 contribution levels.
+class ShowdownResolver {
+  public:
+    // `board` holds the community cards, `button` is the index of the player
+    // on the button. At most `ShowdownResult::kMaxPlayers` players, each with
+    // two hole cards, and at least one of them must not have folded.
+    static ShowdownResult Resolve(CardSet board,
+                                  std::span<const ShowdownPlayer> players,
+                                  u32 button);
+};
+
+} // namespace model
+
+#endif // !SERVER_MODEL_SHOWDOWN_RESOLVER_H_
@@ -5,25 +5,76 @@
 #include "ixwebsocket/IXWebSocket.h"
 #include "ixwebsocket/IXWebSocketMessage.h"
 #include "ixwebsocket/IXWebSocketMessageType.h"
+#include "ixwebsocket/IXWebSocketSendData.h"
 #include "ixwebsocket/IXWebSocketServer.h"
 
-#include <algorithm>
-#include <charconv>
+#include <expected>
 #include <format>
 #include <memory>
-#include <mutex>
+#include <optional>
 #include <print>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <utility>
 
+#include "action_inbox.h"
 #include "lobby.h"
+#include "logger.h"
+#include "net/shared_message.h"
+#include "net/wire_protocol.h"
 #include "server_manager.h"
 #include "stacktrace_analyzer.h"
 
 namespace server {
 
+bool Server::Connection::Send(const common::net::Message& message) const {
+  const std::shared_ptr<ix::WebSocket> ws = web_socket.lock();
+  if (!ws) {
+    return false;
+  }
+  if (wire_format == common::net::WireFormat::kBinary) {
+    ws->sendBinary(common::net::Encode(message, wire_format));
+  } else {
+    ws->send(common::net::EncodeText(message));
+  }
+  return true;
+}
+
+bool Server::Connection::Send(const common::net::SharedMessage& message) const {
+  const std::shared_ptr<ix::WebSocket> ws = web_socket.lock();
+  if (!ws) {
+    return false;
+  }
+  const std::string_view data = message.Get(wire_format);
+  const ix::IXWebSocketSendData send_data(data.data(), data.size());
+  if (wire_format == common::net::WireFormat::kBinary) {
+    ws->sendBinary(send_data);
+  } else {
+    // The server writes its messages in ASCII, so they are not checked for
+    // valid UTF-8 for every recipient.
+    ws->sendUtf8Text(send_data);
+  }
+  return true;
+}
+
+bool Server::Connection::Send(
+  const common::net::SharedMessage& message,
+  const common::net::Message& private_message) const {
+  if (wire_format != common::net::WireFormat::kBinary) {
+    return Send(message) && Send(private_message);
+  }
+  const std::shared_ptr<ix::WebSocket> ws = web_socket.lock();
+  if (!ws) {
+    return false;
+  }
+  // Binary messages carry any number of frames.
+  std::string data{message.Get(wire_format)};
+  common::net::EncodeFrame(private_message, data);
+  ws->sendBinary(data);
+  return true;
+}
+
 Server::Server(int port, const std::string_view& host, Lobby& lobby,
                ConnectionClosureHandler& closure_handler)
   : server_(std::make_unique<ix::WebSocketServer>(port, host.data())),
@@ -37,7 +88,8 @@ void Server::Start() {
   server_->setOnConnectionCallback(
     [&](std::weak_ptr<ix::WebSocket> webSocket,
         std::shared_ptr<ix::ConnectionState> connectionState) {
-      std::print("New connection: {}\n", connectionState->getRemoteIp());
+      common::utility::LogInfo("New connection: {}",
+                               connectionState->getRemoteIp());
       auto ws = webSocket.lock();
       if (!ws) {
         return;
@@ -66,26 +118,36 @@ void Server::MessageHandler::operator()(const ix::WebSocketMessagePtr& msg) {
     if (!server) {
       return;
     }
-    server->OnNewConnectionEstablished(web_socket, state);
+    {
+      const auto subprotocols =
+        msg->openInfo.headers.find("Sec-WebSocket-Protocol");
+      server->OnNewConnectionEstablished(
+        web_socket, state,
+        common::net::NegotiateWireFormat(
+          msg->openInfo.uri, subprotocols != msg->openInfo.headers.end()
+                               ? subprotocols->second
+                               : std::string_view{}));
+    }
 
     break;
 
   case MessageType::Close:
-    std::print("Closing connection [{}].\nReason: {}\nCode: {}\n",
-               state->getId(), msg->closeInfo.reason, msg->closeInfo.code);
+    common::utility::LogInfo("Closing connection [{}]. Reason: {} Code: {}",
+                             state->getId(), msg->closeInfo.reason,
+                             msg->closeInfo.code);
     if (state && server) {
       server->OnConnectionClosed(*state);
     }
     break;
 
   case MessageType::Error:
-    std::print("ERROR: {}", msg->errorInfo.reason);
+    common::utility::LogError("{}", msg->errorInfo.reason);
     break;
 
   case MessageType::Message:
-    // server->OnMessageReceived(msg->str, connection);
-    // std::print("Message from [{}]: {}\n", connection.state->getId(),
-    // msg->str);
+    if (state && server) {
+      server->OnMessageReceived(*state, msg->str);
+    }
     break;
 
   case MessageType::Fragment:
@@ -107,15 +169,17 @@ void Server::End() {
 
 void Server::OnNewConnectionEstablished(
   std::weak_ptr<ix::WebSocket> web_socket,
-  std::shared_ptr<ix::ConnectionState> state) {
+  std::shared_ptr<ix::ConnectionState> state,
+  common::net::WireFormat wire_format) {
   if (stop_) {
     return;
   }
   std::shared_ptr<Connection> connection =
-    std::make_shared<Connection>(web_socket, state);
-  {
-    std::lock_guard lock{connections_mutex_};
-    connections_.push_back(connection);
+    std::make_shared<Connection>(web_socket, state, wire_format);
+  if (!connections_.Insert(connection)) {
+    common::utility::LogWarning("Connection {} is registered already",
+                               connection->id);
+    return;
   }
   lobby_.Push(std::move(connection));
 }
@@ -124,27 +188,47 @@ void Server::OnConnectionClosed(const ix::ConnectionState& state) {
   if (stop_) {
     return;
   }
-  const std::string& sid = state.getId();
-  u64 id = 0;
-  std::from_chars(sid.data(), sid.data() + sid.size(), id, 10);
-
-  auto find_lambda = [id](const std::shared_ptr<Connection> connection) {
-    return connection->id == id;
-  };
-
-  std::lock_guard lock{connections_mutex_};
-
-  auto find_result = std::ranges::find_if(connections_, find_lambda);
-  if (find_result == connections_.end()) {
-    std::print("Closed connection was not in `connections_` "
-               "collection. You're cooked!!!\n");
+  const std::optional<u64> id = ParseConnectionId(state);
+  const std::shared_ptr<Connection> connection =
+    id ? connections_.Remove(*id) : nullptr;
+  if (!connection) {
+    common::utility::LogError("Closed connection was not in `connections_` "
+                              "collection. You're cooked!!!");
+    common::utility::Logger::Instance().Flush();
     common::utility::StacktraceAnalyzer::PrintOut();
-    // std::abort();
+    return;
+  }
+  connection->closed.store(true);
+  common::utility::LogDebug("Connection {} erased from connections_",
+                            connection->id);
+  closure_handler_.OnConnectionClosed(*id);
+}
+
+void Server::OnMessageReceived(const ix::ConnectionState& state,
+                               std::string_view data) {
+  const std::shared_ptr<Connection> connection = connections_.Find(state);
+  if (!connection) {
+    return;
+  }
+  const std::shared_ptr<ActionInbox> inbox = connection->seat.load();
+  if (!inbox) {
+    connection->Send(
+      common::net::TextMessage{.text = "You are not seated at a table"});
+    return;
+  }
+  const std::expected<common::net::ActionMessage, common::net::WireError>
+    action = common::net::DecodeAction(data, connection->wire_format);
+  if (!action) {
+    connection->Send(common::net::TextMessage{.text = "Unknown action"});
+    return;
+  }
+  if (!inbox->TryPush(
+        PlayerAction{.player_id = connection->id, .action = *action})) {
+    common::utility::LogWarning("Inbox full, action of player {} rejected",
+                                connection->id);
+    connection->Send(
+      common::net::TextMessage{.text = "Too many actions, try again"});
   }
-  (*find_result)->closed.store(true);
-  std::print("Connection {} erased from connections_\n", (*find_result)->id);
-  connections_.erase(find_result);
-  closure_handler_.OnConnectionClosed(id);
 }
 
 } // namespace server
@@ -5,20 +5,22 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
-#include <mutex>
-#include <print>
 #include <string>
 #include <string_view>
 #include <utility>
-#include <vector>
 
+#include "action_inbox.h"
 #include "connection_closure_handler.h"
+#include "connection_registry.h"
 #include "ixwebsocket/IXConnectionState.h"
 #include "ixwebsocket/IXWebSocket.h"
 #include "ixwebsocket/IXWebSocketMessage.h"
 #include "ixwebsocket/IXWebSocketServer.h"
 
 #include "aliasing.h"
+#include "logger.h"
+#include "net/shared_message.h"
+#include "net/wire_protocol.h"
 #include "scoped_observation.h"
 #include "server_manager.h"
 
@@ -33,39 +35,62 @@ class Server : public ServerManager::Observer {
         std::shared_ptr<ix::ConnectionState> state{};
         u64 id{(std::numeric_limits<u64>::max)()};
         std::atomic_bool closed{false};
+        // Negotiated when the connection was opened.
+        common::net::WireFormat wire_format{common::net::WireFormat::kText};
+        // The inbox of the table the player is seated at, null while they are
+        // not playing. Copies and moves of a connection are not seated.
+        std::atomic<std::shared_ptr<ActionInbox>> seat{};
 
         Connection(std::weak_ptr<ix::WebSocket> socket,
-                   std::shared_ptr<ix::ConnectionState> connection_state)
+                   std::shared_ptr<ix::ConnectionState> connection_state,
+                   common::net::WireFormat format)
           : web_socket(socket), state(connection_state),
-            id(std::stoull(connection_state->getId())) {
-          std::print("Connection {} constructed\n", id);
+            id(std::stoull(connection_state->getId())), wire_format(format) {
+          common::utility::LogDebug("Connection {} constructed", id);
         }
         Connection(const Connection& other) noexcept
-          : Connection(other.web_socket, other.state) {
-          std::print("Connection {} copied\n", id);
+          : Connection(other.web_socket, other.state, other.wire_format) {
+          common::utility::LogDebug("Connection {} copied", id);
         }
         Connection(Connection&& other) noexcept
           : web_socket(std::move(other.web_socket)),
-            state(std::move(other.state)), id(other.id) {
-          std::print("Connection {} moved\n", id);
+            state(std::move(other.state)), id(other.id),
+            wire_format(other.wire_format) {
+          common::utility::LogDebug("Connection {} moved", id);
         };
 
         void operator=(const Connection& other) noexcept {
           web_socket = other.web_socket;
           state = other.state;
           id = other.id;
-          std::print("Connection {} copy assigned\n", id);
+          wire_format = other.wire_format;
+          common::utility::LogDebug("Connection {} copy assigned", id);
         }
         void operator=(Connection&& other) noexcept {
           web_socket = std::move(other.web_socket);
           state = std::move(other.state);
           id = std::exchange(other.id,
                              (std::numeric_limits<std::uint64_t>::max)());
-          std::print("Connection {} move assigned\n", id);
+          wire_format = other.wire_format;
+          common::utility::LogDebug("Connection {} move assigned", id);
         }
 
+        // Sends `message` in the format of the connection. Returns false if
+        // the player has disconnected.
+        bool Send(const common::net::Message& message) const;
+
+        // Sends the encoding of `message` in the format of the connection,
+        // without building a string for this connection.
+        bool Send(const common::net::SharedMessage& message) const;
+
+        // Sends `message` followed by `private_message`, a part only this
+        // player may see. Binary connections get both frames in one
+        // WebSocket message, text connections two messages.
+        bool Send(const common::net::SharedMessage& message,
+                  const common::net::Message& private_message) const;
+
         ~Connection() {
-          std::print("Connection destroyed\n");
+          common::utility::LogDebug("Connection {} destroyed", id);
         }
     };
 
@@ -77,10 +102,17 @@ class Server : public ServerManager::Observer {
     virtual void End() override;
 
     void OnNewConnectionEstablished(std::weak_ptr<ix::WebSocket> web_socket,
-                                    std::shared_ptr<ix::ConnectionState> state);
+                                    std::shared_ptr<ix::ConnectionState> state,
+                                    common::net::WireFormat wire_format);
 
     void OnConnectionClosed(const ix::ConnectionState& state);
 
+    // Parses an action of a player and routes it to the inbox of their
+    // table. Players who are not seated get an error and the table never
+    // sees the message.
+    void OnMessageReceived(const ix::ConnectionState& state,
+                           std::string_view data);
+
     void AddObserver(Observer* observer);
 
     void RemoveObserver(Observer* observer);
@@ -94,8 +126,7 @@ class Server : public ServerManager::Observer {
         void operator()(const ix::WebSocketMessagePtr& msg);
     };
 
-    std::mutex connections_mutex_;
-    std::vector<std::shared_ptr<Connection>> connections_;
+    ConnectionRegistry<Connection> connections_;
 
     std::atomic_bool stop_{false};
 
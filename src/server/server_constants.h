@@ -16,6 +16,9 @@ inline constexpr u64 gMaxConcurrentConnections = 64;
 
 static inline constexpr u64 gMaxConnectionsInTheLobby = 64;
 
+// Actions a table holds before it rejects more, a power of two.
+inline constexpr u32 gActionInboxCapacity = 256;
+
 } // namespace server
 
 #endif // !SERVER_CONSTANTS_H_
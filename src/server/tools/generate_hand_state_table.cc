@@ -0,0 +1,30 @@
+#include <chrono>
+#include <filesystem>
+#include <print>
+
+#include "aliasing.h"
+#include "model/hand_evaluator.h"
+#include "model/hand_state_table.h"
+
+// Writes the state table used by `HandEvaluator::UseStateTable`. The table
+// does not depend on the machine, so it is generated once and copied along
+// with the analytics binaries.
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::print("Usage: generate_hand_state_table <output file>\n");
+    return 1;
+  }
+  const std::filesystem::path path = argv[1];
+
+  const auto start = std::chrono::steady_clock::now();
+  if (!model::HandStateTable::Generate(path, model::HandEvaluator{})) {
+    std::print("Failed to write {}\n", path.string());
+    return 1;
+  }
+  const std::chrono::duration<f64> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::print("Wrote {} ({:.1f} MB) in {:.1f} s\n", path.string(),
+             std::filesystem::file_size(path) / 1e6, elapsed.count());
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include <chrono>
+#include <filesystem>
+#include <print>
+
+#include "aliasing.h"
+#include "model/equity_calculator.h"
+#include "model/preflop_equity_table.h"
+#include "utility/work_stealing_pool.h"
+
+// Writes the table loaded by `PreflopEquityTable::Open`. The table does not
+// depend on the machine, so it is generated once, on as many cores as
+// possible, and copied along with the server.
+int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::print("Usage: generate_preflop_equity_table <output file>\n");
+    return 1;
+  }
+  const std::filesystem::path path = argv[1];
+
+  common::utility::WorkStealingPool pool;
+  const model::EquityCalculator calculator{pool};
+  std::print("Enumerating preflop matchups on {} threads\n",
+             pool.Concurrency());
+
+  const auto start = std::chrono::steady_clock::now();
+  auto progress = [](u32 done, u32 total) {
+    if (done % 1000 == 0 || done == total) {
+      std::print("Enumerated {} of {} matchups\n", done, total);
+    }
+  };
+  if (!model::PreflopEquityTable::Generate(path, calculator, progress)) {
+    std::print("Failed to write {}\n", path.string());
+    return 1;
+  }
+  const std::chrono::duration<f64> elapsed =
+    std::chrono::steady_clock::now() - start;
+
+  std::print("Wrote {} ({:.1f} MB) in {:.0f} s\n", path.string(),
+             std::filesystem::file_size(path) / 1e6, elapsed.count());
+  return 0;
+}